@@ -0,0 +1,347 @@
+#ifndef OWN_ALLOCATORS_H
+#define OWN_ALLOCATORS_H
+
+// CXX20
+
+#include <new>
+#include <limits>
+#include <memory>
+#include <cstddef>
+#include <utility>
+#include <type_traits>
+#include <memory_resource>
+
+// Allocator adaptor that turns value-initialization into default-initialization.
+// vector<int, default_init_allocator<int>> v(n) and v.resize(n) leave trivial
+// elements uninitialized instead of zero-filling them.
+template< class T, class Allocator = std::allocator<T> >
+class default_init_allocator : public Allocator
+{
+private:
+    using base_traits = std::allocator_traits<Allocator>;
+
+public:
+    template< class U >
+    struct rebind
+    {
+        using other = default_init_allocator<U, typename base_traits::template rebind_alloc<U>>;
+    };
+
+    using Allocator::Allocator;
+
+    default_init_allocator() = default;
+    default_init_allocator(const Allocator& alloc) noexcept : Allocator(alloc) {}
+
+    template< class U, class A >
+    default_init_allocator(const default_init_allocator<U, A>& other) noexcept
+        : Allocator(static_cast<const A&>(other)) {}
+
+    template< class U >
+    void construct(U* ptr) noexcept(std::is_nothrow_default_constructible_v<U>)
+    {
+        ::new (static_cast<void*>(ptr)) U;
+    }
+
+    template< class U, class... Args >
+    void construct(U* ptr, Args&&... args)
+    {
+        base_traits::construct(static_cast<Allocator&>(*this), ptr, std::forward<Args>(args)...);
+    }
+};
+
+// Bump-pointer arena for request-scoped data. deallocate() is a no-op; every chunk is
+// returned at once by release() or the destructor. Not thread-safe.
+class monotonic_arena
+{
+public:
+    explicit monotonic_arena(std::size_t initial_size = 4096) noexcept
+        : m_chunks(nullptr), m_current(nullptr), m_end(nullptr), m_next_size(initial_size > 0 ? initial_size : 4096),
+          m_buffer(nullptr), m_buffer_size(0), m_initial_size(m_next_size) {}
+
+    // Serves allocations from buffer first; the buffer is never freed by the arena
+    monotonic_arena(void* buffer, std::size_t size) noexcept
+        : m_chunks(nullptr), m_current(static_cast<char*>(buffer)), m_end(static_cast<char*>(buffer) + size),
+          m_next_size(size > 0 ? size : 4096), m_buffer(static_cast<char*>(buffer)), m_buffer_size(size),
+          m_initial_size(m_next_size) {}
+
+    monotonic_arena(const monotonic_arena&) = delete;
+    monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+    ~monotonic_arena() { release(); }
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        std::size_t space = m_end - m_current;
+        void* ptr = m_current;
+        if (std::align(alignment, bytes, ptr, space) == nullptr)
+        {
+            grow(bytes + alignment);
+            space = m_end - m_current;
+            ptr = m_current;
+            std::align(alignment, bytes, ptr, space);
+        }
+
+        m_current = static_cast<char*>(ptr) + bytes;
+        return ptr;
+    }
+
+    void deallocate(void*, std::size_t, std::size_t = alignof(std::max_align_t)) noexcept {}
+
+    // Frees every chunk and starts over from the initial buffer, if any, and growth size
+    void release() noexcept
+    {
+        while (m_chunks != nullptr)
+        {
+            chunk* next = m_chunks->next;
+            ::operator delete(m_chunks, m_chunks->size);
+            m_chunks = next;
+        }
+
+        m_current = m_buffer;
+        m_end = m_buffer + m_buffer_size;
+        m_next_size = m_initial_size;
+    }
+
+private:
+    struct alignas(std::max_align_t) chunk
+    {
+        chunk* next;
+        std::size_t size;
+    };
+
+    void grow(std::size_t min_bytes)
+    {
+        while (m_next_size < min_bytes) m_next_size *= 2;
+
+        const std::size_t size = sizeof(chunk) + m_next_size;
+        chunk* new_chunk = static_cast<chunk*>(::operator new(size));
+        new_chunk->next = m_chunks;
+        new_chunk->size = size;
+        m_chunks = new_chunk;
+
+        m_current = reinterpret_cast<char*>(new_chunk + 1);
+        m_end = m_current + m_next_size;
+        m_next_size *= 2;
+    }
+
+    chunk* m_chunks;
+    char* m_current;
+    char* m_end;
+    std::size_t m_next_size;
+    char* m_buffer;
+    std::size_t m_buffer_size;
+    std::size_t m_initial_size;
+};
+
+// Free list of equally sized blocks carved out of larger chunks. Freed blocks are reused
+// by the next allocation; chunks go back to the system only in release() or the destructor.
+class fixed_pool
+{
+public:
+    explicit fixed_pool(std::size_t block_size, std::size_t blocks_per_chunk = 64) noexcept
+        : m_free(nullptr), m_chunks(nullptr),
+          m_block_size(block_size < sizeof(free_block) ? sizeof(free_block)
+                       : (block_size + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1)),
+          m_blocks_per_chunk(blocks_per_chunk > 0 ? blocks_per_chunk : 1) {}
+
+    fixed_pool(const fixed_pool&) = delete;
+    fixed_pool& operator=(const fixed_pool&) = delete;
+
+    ~fixed_pool() { release(); }
+
+    std::size_t block_size() const noexcept { return m_block_size; }
+
+    void* allocate()
+    {
+        if (m_free == nullptr) grow();
+
+        free_block* block = m_free;
+        m_free = block->next;
+        return block;
+    }
+
+    void deallocate(void* ptr) noexcept
+    {
+        if (ptr == nullptr) return;
+
+        free_block* block = static_cast<free_block*>(ptr);
+        block->next = m_free;
+        m_free = block;
+    }
+
+    void release() noexcept
+    {
+        while (m_chunks != nullptr)
+        {
+            chunk* next = m_chunks->next;
+            ::operator delete(m_chunks, m_chunks->size);
+            m_chunks = next;
+        }
+
+        m_free = nullptr;
+    }
+
+private:
+    struct free_block
+    {
+        free_block* next;
+    };
+
+    struct alignas(std::max_align_t) chunk
+    {
+        chunk* next;
+        std::size_t size;
+    };
+
+    void grow()
+    {
+        const std::size_t size = sizeof(chunk) + m_block_size * m_blocks_per_chunk;
+        chunk* new_chunk = static_cast<chunk*>(::operator new(size));
+        new_chunk->next = m_chunks;
+        new_chunk->size = size;
+        m_chunks = new_chunk;
+
+        char* blocks = reinterpret_cast<char*>(new_chunk + 1);
+        for (std::size_t i = m_blocks_per_chunk; i > 0; --i)
+            deallocate(blocks + (i - 1) * m_block_size);
+
+        if (m_blocks_per_chunk < 4096) m_blocks_per_chunk *= 2;
+    }
+
+    free_block* m_free;
+    chunk* m_chunks;
+    std::size_t m_block_size;
+    std::size_t m_blocks_per_chunk;
+};
+
+// One fixed_pool per power-of-two size class from 16 to 1024 bytes. Larger or over-aligned
+// requests go straight to operator new.
+class pool_resource
+{
+public:
+    pool_resource() noexcept
+        : m_pools{ fixed_pool(16), fixed_pool(32), fixed_pool(64), fixed_pool(128),
+                   fixed_pool(256), fixed_pool(512), fixed_pool(1024) } {}
+
+    pool_resource(const pool_resource&) = delete;
+    pool_resource& operator=(const pool_resource&) = delete;
+
+    void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t))
+    {
+        // pairs with the early return in deallocate, so zero-byte blocks are never lost
+        if (bytes == 0) return nullptr;
+
+        if (bytes > max_pooled || alignment > alignof(std::max_align_t))
+            return ::operator new(bytes, std::align_val_t(alignment));
+
+        return m_pools[size_class(bytes)].allocate();
+    }
+
+    void deallocate(void* ptr, std::size_t bytes, std::size_t alignment = alignof(std::max_align_t)) noexcept
+    {
+        if (ptr == nullptr || bytes == 0) return;
+
+        if (bytes > max_pooled || alignment > alignof(std::max_align_t))
+            ::operator delete(ptr, bytes, std::align_val_t(alignment));
+        else
+            m_pools[size_class(bytes)].deallocate(ptr);
+    }
+
+    void release() noexcept
+    {
+        for (fixed_pool& pool : m_pools) pool.release();
+    }
+
+private:
+    static constexpr std::size_t max_pooled = 1024;
+
+    static std::size_t size_class(std::size_t bytes) noexcept
+    {
+        std::size_t index = 0;
+        for (std::size_t size = 16; size < bytes; size *= 2) ++index;
+        return index;
+    }
+
+    fixed_pool m_pools[7];
+};
+
+// Typed allocator handle over any of the resources above (anything with
+// allocate(bytes, align) / deallocate(ptr, bytes, align)). Copies share the resource and
+// compare equal; like std::pmr, the allocator does not propagate between containers.
+template< class T, class Resource >
+class resource_allocator
+{
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::false_type;
+    using propagate_on_container_swap = std::false_type;
+    using is_always_equal = std::false_type;
+
+    resource_allocator(Resource& resource) noexcept : m_resource(&resource) {}
+
+    template< class U >
+    resource_allocator(const resource_allocator<U, Resource>& other) noexcept : m_resource(other.resource()) {}
+
+    T* allocate(std::size_t n)
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(m_resource->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* ptr, std::size_t n) noexcept
+    {
+        m_resource->deallocate(ptr, n * sizeof(T), alignof(T));
+    }
+
+    Resource* resource() const noexcept { return m_resource; }
+
+    template< class U >
+    friend bool operator==(const resource_allocator& lhs, const resource_allocator<U, Resource>& rhs) noexcept
+    {
+        return lhs.resource() == rhs.resource();
+    }
+
+private:
+    Resource* m_resource;
+};
+
+template< class T >
+using arena_allocator = resource_allocator<T, monotonic_arena>;
+
+template< class T >
+using pool_allocator = resource_allocator<T, pool_resource>;
+
+// Exposes one of the resources above as a std::pmr::memory_resource, so it can back
+// std::pmr::polymorphic_allocator and the std::pmr containers as well.
+template< class Resource >
+class pmr_adaptor : public std::pmr::memory_resource
+{
+public:
+    explicit pmr_adaptor(Resource& resource) noexcept : m_resource(&resource) {}
+
+    Resource* resource() const noexcept { return m_resource; }
+
+private:
+    // memory_resource must hand out a pointer even for zero bytes, which pool_resource
+    // answers with null; those requests take the smallest block instead
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        return m_resource->allocate(bytes > 0 ? bytes : 1, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) override
+    {
+        m_resource->deallocate(ptr, bytes > 0 ? bytes : 1, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        const pmr_adaptor* adaptor = dynamic_cast<const pmr_adaptor*>(&other);
+        return adaptor != nullptr && adaptor->m_resource == m_resource;
+    }
+
+    Resource* m_resource;
+};
+
+#endif //! OWN_ALLOCATORS_H
@@ -0,0 +1,703 @@
+#ifndef _OWN_BTREE_SET_HPP_
+#define _OWN_BTREE_SET_HPP_
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <concepts>
+#include <iterator>
+#include <utility>
+#include <initializer_list>
+
+
+// Ordered set keeping many keys per node: a leaf holds as many keys as fit in NodeBytes and an
+// internal node adds a child pointer per key, so a lookup touches a few cache lines per level
+// and the tree is only a few levels deep. Iterators stay valid until the next insert or erase.
+template< class Key, class Compare = std::less<Key>, class Allocator = std::allocator<Key>,
+    std::size_t NodeBytes = 256 >
+class btree_set
+{
+private:
+    struct leaf_node;
+    struct internal_node;
+    class tree_iter;
+
+public:
+    using key_type = Key;
+    using value_type = Key;
+    using size_type = size_t;
+    using difference_type = std::ptrdiff_t;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
+    using reference = Key&;
+    using const_reference = const Key&;
+    using pointer = Key*;
+    using const_pointer = const Key*;
+    using iterator = tree_iter;
+    using const_iterator = tree_iter;
+
+private:
+    static constexpr size_type header_bytes = sizeof(void*) + 2 * sizeof(std::uint16_t) + sizeof(bool);
+
+public:
+    // keys per node
+    static constexpr size_type node_capacity = std::clamp<size_type>(
+        NodeBytes > header_bytes ? (NodeBytes - header_bytes) / sizeof(Key) : 0, 3, UINT16_MAX - 1);
+
+public:
+    // constructors and destructor
+    btree_set() {}
+    explicit btree_set( const Compare& comp, const Allocator& alloc = Allocator() ) : m_comp(comp), m_alloc(alloc) {}
+    explicit btree_set( const Allocator& alloc ) : m_alloc(alloc) {}
+    template< std::input_iterator InputIt >
+    btree_set( InputIt first, InputIt last,
+        const Compare& comp = Compare(), const Allocator& alloc = Allocator() );
+    btree_set( const btree_set& other );
+    btree_set( btree_set&& other ) noexcept;
+    btree_set( std::initializer_list<value_type> init,
+        const Compare& comp = Compare(), const Allocator& alloc = Allocator() );
+    ~btree_set() { clear(); }
+
+    // assignment operators
+    btree_set& operator=( const btree_set& other );
+    btree_set& operator=( btree_set&& other )
+        noexcept(leaf_allocator_traits::propagate_on_container_move_assignment::value || leaf_allocator_traits::is_always_equal::value);
+    btree_set& operator=( std::initializer_list<value_type> ilist );
+
+    allocator_type get_allocator() const noexcept { return allocator_type(m_alloc); }
+
+    // iterators; begin and end descend the few levels of the tree
+    iterator begin() const noexcept;
+    const_iterator cbegin() const noexcept { return begin(); }
+
+    iterator end() const noexcept;
+    const_iterator cend() const noexcept { return end(); }
+
+    // capacity
+    bool empty() const noexcept { return m_size == 0; }
+    size_type size() const noexcept { return m_size; }
+
+    // modifiers
+    void clear();
+
+    std::pair<iterator, bool> insert( const value_type& key ) { return insert_impl(key); }
+    std::pair<iterator, bool> insert( value_type&& key ) { return insert_impl(std::move(key)); }
+
+    iterator erase( const_iterator pos );
+
+    void swap( btree_set& other ) noexcept;
+
+    // lookup
+    iterator find( const value_type& key ) const;
+
+    // observers
+    key_compare key_comp() const { return m_comp; }
+    value_compare value_comp() const { return m_comp; }
+
+
+private:
+    static constexpr size_type max_keys = node_capacity;
+    // a split leaves max_keys / 2 and (max_keys - 1) / 2 keys, two minimal nodes and a separator fit in one
+    static constexpr size_type min_keys = (max_keys - 1) / 2;
+
+    struct leaf_node
+    {
+        internal_node* parent = nullptr;
+        std::uint16_t position = 0;     // index among the parent's children
+        std::uint16_t count = 0;        // keys in use
+        bool leaf = true;
+        alignas(Key) unsigned char storage[sizeof(Key) * max_keys];
+
+        Key* slot( size_type i ) noexcept { return reinterpret_cast<Key*>(storage) + i; }
+        Key& key( size_type i ) noexcept { return *std::launder(slot(i)); }
+
+        template< class... Args >
+        void emplace_key( size_type i, Args&&... args )
+        {
+            if (i == count) ::new (static_cast<void*>(slot(count))) Key(std::forward<Args>(args)...);
+            else
+            {
+                Key value(std::forward<Args>(args)...);
+                ::new (static_cast<void*>(slot(count))) Key(std::move(key(count - 1)));
+                std::move_backward(&key(i), &key(count - 1), &key(count));
+                key(i) = std::move(value);
+            }
+            ++count;
+        }
+
+        void erase_key( size_type i ) noexcept
+        {
+            std::move(&key(i + 1), &key(count), &key(i));
+            std::destroy_at(&key(count - 1));
+            --count;
+        }
+    };
+
+    struct internal_node : leaf_node
+    {
+        leaf_node* children[max_keys + 1] = {};
+
+        internal_node() { this->leaf = false; }
+
+        void set_child( size_type i, leaf_node* child ) noexcept
+        {
+            children[i] = child;
+            child->parent = this;
+            child->position = static_cast<std::uint16_t>(i);
+        }
+    };
+
+    static internal_node* as_internal( leaf_node* node ) noexcept { return static_cast<internal_node*>(node); }
+    static const internal_node* as_internal( const leaf_node* node ) noexcept { return static_cast<const internal_node*>(node); }
+
+    class tree_iter
+    {
+    private:
+        friend class btree_set;
+
+    public:
+        using value_type = Key;
+        using difference_type = std::ptrdiff_t;
+        using reference = const Key&;
+        using pointer = const Key*;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+    private:
+        tree_iter( leaf_node* node, size_type index ) : m_node( node ), m_index( index ) {}
+
+        leaf_node* m_node = nullptr;
+        size_type m_index = 0;
+
+    public:
+        tree_iter() = default;
+
+        reference operator * () const noexcept { return m_node->key(m_index); }
+        pointer operator -> () const noexcept { return &m_node->key(m_index); }
+        tree_iter& operator ++ ();
+        tree_iter& operator -- ();
+        tree_iter operator ++ (int) { tree_iter tmp = *this; ++(*this); return tmp; }
+        tree_iter operator -- (int) { tree_iter tmp = *this; --(*this); return tmp; }
+        bool operator == ( const tree_iter& other ) const { return m_node == other.m_node && m_index == other.m_index; }
+    };
+
+    using leaf_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<leaf_node>;
+    using leaf_allocator_traits = typename std::allocator_traits<Allocator>::template rebind_traits<leaf_node>;
+    using internal_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<internal_node>;
+    using internal_allocator_traits = typename std::allocator_traits<Allocator>::template rebind_traits<internal_node>;
+
+    leaf_node* create_leaf()
+    {
+        leaf_node* node = leaf_allocator_traits::allocate(m_alloc, 1);
+        leaf_allocator_traits::construct(m_alloc, node);
+        return node;
+    }
+
+    internal_node* create_internal()
+    {
+        internal_allocator alloc(m_alloc);
+        internal_node* node = internal_allocator_traits::allocate(alloc, 1);
+        internal_allocator_traits::construct(alloc, node);
+        return node;
+    }
+
+    // Frees a node whose keys are already destroyed
+    void destroy_node( leaf_node* node ) noexcept
+    {
+        if (node->leaf)
+        {
+            leaf_allocator_traits::destroy(m_alloc, node);
+            leaf_allocator_traits::deallocate(m_alloc, node, 1);
+        }
+        else
+        {
+            internal_allocator alloc(m_alloc);
+            internal_allocator_traits::destroy(alloc, as_internal(node));
+            internal_allocator_traits::deallocate(alloc, as_internal(node), 1);
+        }
+    }
+
+    leaf_node* m_root = nullptr;
+    size_type m_size = 0;
+    Compare m_comp;
+    leaf_allocator m_alloc;
+
+    // healping methods for the b-tree
+    size_type lower_bound_in( leaf_node* node, const Key& key ) const;
+    iterator lower_bound_impl( const Key& key ) const;
+
+    template< class K >
+    std::pair<iterator, bool> insert_impl( K&& key );
+    void split( leaf_node* node );
+
+    void rebalance( leaf_node* node );
+    void rotate_right( leaf_node* left, leaf_node* node );
+    void rotate_left( leaf_node* node, leaf_node* right );
+    void merge_nodes( leaf_node* left, leaf_node* right );
+
+    void destroy_subtree( leaf_node* node ) noexcept;
+    leaf_node* clone_subtree( leaf_node* node );
+};
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+template< std::input_iterator InputIt >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::btree_set( InputIt first, InputIt last, const Compare& comp, const Allocator& alloc )
+    : m_comp(comp), m_alloc(alloc)
+{
+    for (; first != last; ++first) insert(*first);
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::btree_set( std::initializer_list<value_type> init, const Compare& comp, const Allocator& alloc )
+    : m_comp(comp), m_alloc(alloc)
+{
+    for (const auto& key : init) insert(key);
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::btree_set( const btree_set& other )
+    : m_comp(other.m_comp), m_alloc(leaf_allocator_traits::select_on_container_copy_construction(other.m_alloc))
+{
+    m_root = clone_subtree(other.m_root);
+    m_size = other.m_size;
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::btree_set( btree_set&& other ) noexcept
+    : m_root(other.m_root), m_size(other.m_size), m_comp(other.m_comp), m_alloc(other.m_alloc)
+{
+    other.m_root = nullptr;
+    other.m_size = 0;
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>& btree_set<Key, Compare, Allocator, NodeBytes>::operator=( const btree_set& other )
+{
+    if (this == &other) return *this;
+
+    clear();
+    m_comp = other.m_comp;
+    if constexpr (leaf_allocator_traits::propagate_on_container_copy_assignment::value)
+        m_alloc = other.m_alloc;
+
+    m_root = clone_subtree(other.m_root);
+    m_size = other.m_size;
+    return *this;
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>& btree_set<Key, Compare, Allocator, NodeBytes>::operator=( btree_set&& other )
+    noexcept(leaf_allocator_traits::propagate_on_container_move_assignment::value || leaf_allocator_traits::is_always_equal::value)
+{
+    if (this == &other) return *this;
+
+    clear();
+    m_comp = other.m_comp;
+    if constexpr (leaf_allocator_traits::propagate_on_container_move_assignment::value)
+        m_alloc = std::move(other.m_alloc);
+    else if (m_alloc != other.m_alloc)
+    {
+        // nodes owned by another allocator cannot change hands, move the keys instead
+        for (auto it = other.begin(); it != other.end(); ++it) insert(std::move(const_cast<Key&>(*it)));
+        other.clear();
+        return *this;
+    }
+
+    m_root = other.m_root;
+    m_size = other.m_size;
+    other.m_root = nullptr;
+    other.m_size = 0;
+    return *this;
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>& btree_set<Key, Compare, Allocator, NodeBytes>::operator=( std::initializer_list<value_type> ilist )
+{
+    clear();
+    for (const auto& key : ilist) insert(key);
+    return *this;
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::tree_iter& btree_set<Key, Compare, Allocator, NodeBytes>::tree_iter::operator ++ ()
+{
+    if (!m_node->leaf)
+    {
+        m_node = as_internal(m_node)->children[m_index + 1];
+        while (!m_node->leaf) m_node = as_internal(m_node)->children[0];
+        m_index = 0;
+        return *this;
+    }
+
+    if (++m_index < m_node->count) return *this;
+
+    // climb to the first ancestor with a key to the right; past the last key stay at end
+    tree_iter save = *this;
+    while (m_index == m_node->count && m_node->parent != nullptr)
+    {
+        m_index = m_node->position;
+        m_node = m_node->parent;
+    }
+    if (m_index == m_node->count) *this = save;
+    return *this;
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::tree_iter& btree_set<Key, Compare, Allocator, NodeBytes>::tree_iter::operator -- ()
+{
+    if (!m_node->leaf)
+    {
+        m_node = as_internal(m_node)->children[m_index];
+        while (!m_node->leaf) m_node = as_internal(m_node)->children[m_node->count];
+        m_index = m_node->count - 1;
+        return *this;
+    }
+
+    while (m_index == 0 && m_node->parent != nullptr)
+    {
+        m_index = m_node->position;
+        m_node = m_node->parent;
+    }
+    --m_index;
+    return *this;
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::iterator btree_set<Key, Compare, Allocator, NodeBytes>::begin() const noexcept
+{
+    if (m_root == nullptr) return iterator();
+
+    leaf_node* node = m_root;
+    while (!node->leaf) node = as_internal(node)->children[0];
+    return iterator(node, 0);
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::iterator btree_set<Key, Compare, Allocator, NodeBytes>::end() const noexcept
+{
+    if (m_root == nullptr) return iterator();
+
+    leaf_node* node = m_root;
+    while (!node->leaf) node = as_internal(node)->children[node->count];
+    return iterator(node, node->count);
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline void btree_set<Key, Compare, Allocator, NodeBytes>::clear()
+{
+    destroy_subtree(m_root);
+    m_root = nullptr;
+    m_size = 0;
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline void btree_set<Key, Compare, Allocator, NodeBytes>::swap( btree_set& other ) noexcept
+{
+    using std::swap;
+    swap(m_root, other.m_root);
+    swap(m_size, other.m_size);
+    swap(m_comp, other.m_comp);
+    if constexpr (leaf_allocator_traits::propagate_on_container_swap::value)
+        swap(m_alloc, other.m_alloc);
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::size_type btree_set<Key, Compare, Allocator, NodeBytes>::lower_bound_in( leaf_node* node, const Key& key ) const
+{
+    return std::lower_bound(&node->key(0), &node->key(0) + node->count, key, m_comp) - &node->key(0);
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::iterator btree_set<Key, Compare, Allocator, NodeBytes>::lower_bound_impl( const Key& key ) const
+{
+    // every level narrows the candidate; keys below it in the tree are smaller
+    iterator result = end();
+    leaf_node* node = m_root;
+    while (node != nullptr)
+    {
+        size_type index = lower_bound_in(node, key);
+        if (index < node->count)
+        {
+            result = iterator(node, index);
+            if (!m_comp(key, node->key(index))) return result;
+        }
+        if (node->leaf) break;
+        node = as_internal(node)->children[index];
+    }
+    return result;
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::iterator btree_set<Key, Compare, Allocator, NodeBytes>::find( const Key& key ) const
+{
+    leaf_node* node = m_root;
+    while (node != nullptr)
+    {
+        size_type index = lower_bound_in(node, key);
+        if (index < node->count && !m_comp(key, node->key(index))) return iterator(node, index);
+        if (node->leaf) break;
+        node = as_internal(node)->children[index];
+    }
+    return end();
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+template< class K >
+inline std::pair<typename btree_set<Key, Compare, Allocator, NodeBytes>::iterator, bool> btree_set<Key, Compare, Allocator, NodeBytes>::insert_impl( K&& key )
+{
+    if (m_root == nullptr)
+    {
+        leaf_node* root = create_leaf();
+        try
+        {
+            root->emplace_key(0, std::forward<K>(key));
+        }
+        catch (...)
+        {
+            destroy_node(root);
+            throw;
+        }
+        m_root = root;
+        m_size = 1;
+        return std::make_pair(iterator(m_root, 0), true);
+    }
+
+    leaf_node* node = m_root;
+    size_type index = 0;
+    while (true)
+    {
+        index = lower_bound_in(node, key);
+        if (index < node->count && !m_comp(key, node->key(index))) return std::make_pair(iterator(node, index), false);
+        if (node->leaf) break;
+        node = as_internal(node)->children[index];
+    }
+
+    if (node->count == max_keys)
+    {
+        split(node);
+        if (index > node->count)
+        {
+            index -= node->count + 1;
+            node = node->parent->children[node->position + 1];
+        }
+    }
+
+    node->emplace_key(index, std::forward<K>(key));
+    ++m_size;
+    return std::make_pair(iterator(node, index), true);
+}
+
+// Moves the upper half of a full node into a new right sibling and its median up into the
+// parent, splitting full ancestors first
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline void btree_set<Key, Compare, Allocator, NodeBytes>::split( leaf_node* node )
+{
+    if (node->parent != nullptr && node->parent->count == max_keys) split(node->parent);
+
+    leaf_node* sibling = node->leaf ? create_leaf() : create_internal();
+    internal_node* parent = node->parent;
+    if (parent == nullptr)
+    {
+        try
+        {
+            parent = create_internal();
+        }
+        catch (...)
+        {
+            destroy_node(sibling);
+            throw;
+        }
+        parent->set_child(0, node);
+        m_root = parent;
+    }
+
+    const size_type mid = max_keys / 2;
+    for (size_type i = mid + 1; i < node->count; ++i)
+        ::new (static_cast<void*>(sibling->slot(i - mid - 1))) Key(std::move(node->key(i)));
+    sibling->count = static_cast<std::uint16_t>(node->count - mid - 1);
+
+    if (!node->leaf)
+    {
+        for (size_type i = mid + 1; i <= node->count; ++i)
+            as_internal(sibling)->set_child(i - mid - 1, as_internal(node)->children[i]);
+    }
+
+    Key median(std::move(node->key(mid)));
+    std::destroy(&node->key(mid), &node->key(0) + node->count);
+    node->count = static_cast<std::uint16_t>(mid);
+
+    const size_type position = node->position;
+    parent->emplace_key(position, std::move(median));
+    for (size_type i = parent->count; i > position + 1; --i) parent->set_child(i, parent->children[i - 1]);
+    parent->set_child(position + 1, sibling);
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::iterator btree_set<Key, Compare, Allocator, NodeBytes>::erase( const_iterator pos )
+{
+    leaf_node* node = pos.m_node;
+    size_type index = pos.m_index;
+    if (node == nullptr || index == node->count) return end();
+
+    // keys of internal nodes are replaced by their predecessor, which always sits in a leaf
+    Key removed(std::move(node->key(index)));
+    if (!node->leaf)
+    {
+        leaf_node* leaf = as_internal(node)->children[index];
+        while (!leaf->leaf) leaf = as_internal(leaf)->children[leaf->count];
+
+        node->key(index) = std::move(leaf->key(leaf->count - 1));
+        node = leaf;
+        index = leaf->count - 1;
+    }
+
+    node->erase_key(index);
+    --m_size;
+    rebalance(node);
+
+    // nodes may have merged, find the successor by key
+    return lower_bound_impl(removed);
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline void btree_set<Key, Compare, Allocator, NodeBytes>::rebalance( leaf_node* node )
+{
+    while (node != m_root && node->count < min_keys)
+    {
+        internal_node* parent = node->parent;
+        const size_type position = node->position;
+        leaf_node* left = (position > 0) ? parent->children[position - 1] : nullptr;
+        leaf_node* right = (position < parent->count) ? parent->children[position + 1] : nullptr;
+
+        if (left != nullptr && left->count > min_keys) return rotate_right(left, node);
+        if (right != nullptr && right->count > min_keys) return rotate_left(node, right);
+
+        if (left != nullptr) merge_nodes(left, node);
+        else merge_nodes(node, right);
+        node = parent;
+    }
+
+    if (m_root->count == 0)
+    {
+        leaf_node* old_root = m_root;
+        m_root = old_root->leaf ? nullptr : as_internal(old_root)->children[0];
+        if (m_root != nullptr)
+        {
+            m_root->parent = nullptr;
+            m_root->position = 0;
+        }
+        destroy_node(old_root);
+    }
+}
+
+// Moves the separator down into node and the last key of left up in its place
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline void btree_set<Key, Compare, Allocator, NodeBytes>::rotate_right( leaf_node* left, leaf_node* node )
+{
+    internal_node* parent = node->parent;
+    const size_type separator = node->position - 1;
+
+    node->emplace_key(0, std::move(parent->key(separator)));
+    parent->key(separator) = std::move(left->key(left->count - 1));
+
+    if (!node->leaf)
+    {
+        for (size_type i = node->count; i > 0; --i) as_internal(node)->set_child(i, as_internal(node)->children[i - 1]);
+        as_internal(node)->set_child(0, as_internal(left)->children[left->count]);
+    }
+
+    left->erase_key(left->count - 1);
+}
+
+// Moves the separator down into node and the first key of right up in its place
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline void btree_set<Key, Compare, Allocator, NodeBytes>::rotate_left( leaf_node* node, leaf_node* right )
+{
+    internal_node* parent = node->parent;
+    const size_type separator = node->position;
+
+    node->emplace_key(node->count, std::move(parent->key(separator)));
+    parent->key(separator) = std::move(right->key(0));
+
+    if (!node->leaf)
+    {
+        as_internal(node)->set_child(node->count, as_internal(right)->children[0]);
+        for (size_type i = 0; i < right->count; ++i) as_internal(right)->set_child(i, as_internal(right)->children[i + 1]);
+    }
+
+    right->erase_key(0);
+}
+
+// Appends the separator and all of right to left, then drops right from the parent
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline void btree_set<Key, Compare, Allocator, NodeBytes>::merge_nodes( leaf_node* left, leaf_node* right )
+{
+    internal_node* parent = left->parent;
+    const size_type separator = left->position;
+
+    left->emplace_key(left->count, std::move(parent->key(separator)));
+
+    const size_type base = left->count;
+    for (size_type i = 0; i < right->count; ++i)
+        ::new (static_cast<void*>(left->slot(base + i))) Key(std::move(right->key(i)));
+
+    if (!left->leaf)
+    {
+        for (size_type i = 0; i <= right->count; ++i)
+            as_internal(left)->set_child(base + i, as_internal(right)->children[i]);
+    }
+
+    left->count = static_cast<std::uint16_t>(base + right->count);
+    std::destroy(&right->key(0), &right->key(0) + right->count);
+    right->count = 0;
+
+    parent->erase_key(separator);
+    for (size_type i = separator + 1; i <= parent->count; ++i) parent->set_child(i, parent->children[i + 1]);
+    destroy_node(right);
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline void btree_set<Key, Compare, Allocator, NodeBytes>::destroy_subtree( leaf_node* node ) noexcept
+{
+    if (node == nullptr) return;
+
+    if (!node->leaf)
+    {
+        for (size_type i = 0; i <= node->count; ++i) destroy_subtree(as_internal(node)->children[i]);
+    }
+
+    std::destroy(&node->key(0), &node->key(0) + node->count);
+    destroy_node(node);
+}
+
+template< class Key, class Compare, class Allocator, std::size_t NodeBytes >
+inline btree_set<Key, Compare, Allocator, NodeBytes>::leaf_node* btree_set<Key, Compare, Allocator, NodeBytes>::clone_subtree( leaf_node* node )
+{
+    if (node == nullptr) return nullptr;
+
+    leaf_node* copy = node->leaf ? create_leaf() : create_internal();
+    try
+    {
+        for (; copy->count < node->count; ++copy->count)
+            ::new (static_cast<void*>(copy->slot(copy->count))) Key(node->key(copy->count));
+
+        if (!node->leaf)
+        {
+            for (size_type i = 0; i <= node->count; ++i)
+                as_internal(copy)->set_child(i, clone_subtree(as_internal(node)->children[i]));
+        }
+    }
+    catch (...)
+    {
+        // children not cloned yet are still null
+        destroy_subtree(copy);
+        throw;
+    }
+    return copy;
+}
+
+
+#endif //!_OWN_BTREE_SET_HPP_
@@ -0,0 +1,381 @@
+#ifndef OWN_FLAT_SET_H
+#define OWN_FLAT_SET_H
+
+// CXX20
+
+#include <bit>
+#include <memory>
+#include <cstddef>
+#include <concepts>
+#include <iterator>
+#include <ranges>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <initializer_list>
+
+#include "vector.hpp"
+
+// Layouts for the lookup structure of flat_set
+
+// Binary search over the sorted keys
+struct sorted_layout {};
+
+// Additionally keeps a copy of the keys in breadth-first (Eytzinger) order: the four levels
+// below a probe share a cache line or two and are prefetched while the probe is compared.
+// Every modification rebuilds the copy, so it suits sets built once and queried often.
+struct eytzinger_layout {};
+
+// Sorted set stored in one contiguous container. Lookups are branchless binary searches,
+// inserting or erasing a single key moves the keys behind it, and insertion of a range
+// appends, sorts the new part and merges it in.
+template< class Key, class Compare = std::less<Key>, class Container = vector<Key>, class Layout = sorted_layout >
+class flat_set
+{
+public:
+    // Type declaration
+    using key_type                 =    Key;
+    using value_type               =    Key;
+    using key_compare              =    Compare;
+    using value_compare            =    Compare;
+    using container_type           =    Container;
+    using size_type                =    typename Container::size_type;
+    using difference_type          =    typename Container::difference_type;
+    using reference                =    value_type&;
+    using const_reference          =    const value_type&;
+    using iterator                 =    typename Container::const_iterator;
+    using const_iterator           =    typename Container::const_iterator;
+    using reverse_iterator         =    std::reverse_iterator<iterator>;
+    using const_reverse_iterator   =    std::reverse_iterator<const_iterator>;
+
+    static_assert(std::same_as<Layout, sorted_layout> || std::same_as<Layout, eytzinger_layout>,
+                  "Layout must be sorted_layout or eytzinger_layout");
+
+    // Constructors
+    flat_set() = default;
+    explicit flat_set(const Compare& comp) : m_comp(comp) {}
+    template< std::input_iterator InputIt >
+    flat_set(InputIt first, InputIt last, const Compare& comp = Compare());
+    flat_set(std::initializer_list<Key> init, const Compare& comp = Compare());
+
+    flat_set& operator=(std::initializer_list<Key> ilist);
+
+    // Iterators
+    iterator begin() const noexcept { return m_keys.begin(); }
+    const_iterator cbegin() const noexcept { return m_keys.begin(); }
+
+    iterator end() const noexcept { return m_keys.end(); }
+    const_iterator cend() const noexcept { return m_keys.end(); }
+
+    reverse_iterator rbegin() const noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+
+    reverse_iterator rend() const noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+    // Capacity
+    bool empty() const noexcept { return m_keys.empty(); }
+    size_type size() const noexcept { return m_keys.size(); }
+    void reserve(size_type new_cap) { m_keys.reserve(new_cap); }
+
+    // Modifiers
+    void clear() noexcept;
+
+    std::pair<iterator, bool> insert(const value_type& value) { return insert_impl(value); }
+    std::pair<iterator, bool> insert(value_type&& value) { return insert_impl(std::move(value)); }
+    template< std::input_iterator InputIt >
+    void insert(InputIt first, InputIt last) { insert_range(std::ranges::subrange(first, last)); }
+    void insert(std::initializer_list<Key> ilist) { insert_range(ilist); }
+    template< std::ranges::input_range R >
+        requires std::convertible_to<std::ranges::range_reference_t<R>, Key>
+    void insert_range(R&& rg);
+
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+    void swap(flat_set& other) noexcept;
+
+    // Hands the sorted keys out and leaves the set empty
+    Container extract() &&;
+
+    // Lookup
+    iterator find(const Key& key) const;
+    bool contains(const Key& key) const { return find(key) != end(); }
+    size_type count(const Key& key) const { return contains(key) ? 1 : 0; }
+    iterator lower_bound(const Key& key) const;
+    iterator upper_bound(const Key& key) const;
+
+    // Observers
+    key_compare key_comp() const { return m_comp; }
+    value_compare value_comp() const { return m_comp; }
+
+private:
+    static constexpr bool use_eytzinger = std::same_as<Layout, eytzinger_layout>;
+
+    // Node k (1-based) of the implicit tree has children 2k and 2k + 1 and lives at keys[k - 1]
+    struct eytzinger_index
+    {
+        Container keys;
+    };
+    struct no_index {};
+
+    template< class K >
+    std::pair<iterator, bool> insert_impl(K&& value);
+
+    // Restores order and uniqueness after keys were appended from position old_size on
+    void merge_tail(size_type old_size);
+
+    size_type lower_bound_index(const Key& key) const;
+    size_type lower_bound_node(const Key& key) const;
+    size_type node_rank(size_type node) const noexcept;
+    void rebuild_index();
+    void fill_index(size_type node, size_type& next);
+
+    Container m_keys;
+    [[no_unique_address]] Compare m_comp;
+    [[no_unique_address]] std::conditional_t<use_eytzinger, eytzinger_index, no_index> m_index;
+};
+
+template< class Key, class Compare, class Container, class Layout >
+template< std::input_iterator InputIt >
+flat_set<Key, Compare, Container, Layout>::flat_set(InputIt first, InputIt last, const Compare& comp)
+    : m_comp(comp)
+{
+    insert(first, last);
+}
+
+template< class Key, class Compare, class Container, class Layout >
+flat_set<Key, Compare, Container, Layout>::flat_set(std::initializer_list<Key> init, const Compare& comp)
+    : m_comp(comp)
+{
+    insert(init.begin(), init.end());
+}
+
+template< class Key, class Compare, class Container, class Layout >
+flat_set<Key, Compare, Container, Layout>& flat_set<Key, Compare, Container, Layout>::operator=(std::initializer_list<Key> ilist)
+{
+    clear();
+    insert(ilist.begin(), ilist.end());
+    return *this;
+}
+
+template< class Key, class Compare, class Container, class Layout >
+void flat_set<Key, Compare, Container, Layout>::clear() noexcept
+{
+    m_keys.clear();
+    if constexpr (use_eytzinger)
+    {
+        m_index.keys.clear();
+    }
+}
+
+template< class Key, class Compare, class Container, class Layout >
+template< class K >
+std::pair<typename flat_set<Key, Compare, Container, Layout>::iterator, bool> flat_set<Key, Compare, Container, Layout>::insert_impl(K&& value)
+{
+    size_type pos = lower_bound_index(value);
+    if (pos != m_keys.size() && !m_comp(value, m_keys[pos])) return std::make_pair(begin() + pos, false);
+
+    m_keys.insert(m_keys.cbegin() + pos, std::forward<K>(value));
+    if constexpr (use_eytzinger) rebuild_index();
+    return std::make_pair(begin() + pos, true);
+}
+
+// Walks the range itself, so ranges whose sentinel differs from the iterator work too
+template< class Key, class Compare, class Container, class Layout >
+template< std::ranges::input_range R >
+    requires std::convertible_to<std::ranges::range_reference_t<R>, Key>
+void flat_set<Key, Compare, Container, Layout>::insert_range(R&& rg)
+{
+    const size_type old_size = m_keys.size();
+    try
+    {
+        for (auto&& key : rg) m_keys.push_back(std::forward<decltype(key)>(key));
+    }
+    catch (...)
+    {
+        m_keys.erase(m_keys.cbegin() + old_size, m_keys.cend());
+        throw;
+    }
+    merge_tail(old_size);
+}
+
+template< class Key, class Compare, class Container, class Layout >
+void flat_set<Key, Compare, Container, Layout>::merge_tail(size_type old_size)
+{
+    auto first = m_keys.begin();
+    auto middle = first + old_size;
+    auto last = m_keys.end();
+    if (middle == last) return;
+
+    // stable throughout, so of equal keys the one already present, then the first appended, survives
+    std::stable_sort(middle, last, m_comp);
+    if (old_size != 0 && m_comp(*middle, *(middle - 1))) std::inplace_merge(first, middle, last, m_comp);
+
+    auto unique_end = std::unique(first, last, [this](const Key& lhs, const Key& rhs) { return !m_comp(lhs, rhs); });
+    m_keys.erase(unique_end, m_keys.end());
+
+    if constexpr (use_eytzinger) rebuild_index();
+}
+
+template< class Key, class Compare, class Container, class Layout >
+typename flat_set<Key, Compare, Container, Layout>::iterator flat_set<Key, Compare, Container, Layout>::erase(const_iterator pos)
+{
+    const difference_type index = pos - begin();
+    m_keys.erase(pos);
+    if constexpr (use_eytzinger) rebuild_index();
+    return begin() + index;
+}
+
+template< class Key, class Compare, class Container, class Layout >
+typename flat_set<Key, Compare, Container, Layout>::iterator flat_set<Key, Compare, Container, Layout>::erase(const_iterator first, const_iterator last)
+{
+    const difference_type index = first - begin();
+    m_keys.erase(first, last);
+    if constexpr (use_eytzinger) rebuild_index();
+    return begin() + index;
+}
+
+template< class Key, class Compare, class Container, class Layout >
+void flat_set<Key, Compare, Container, Layout>::swap(flat_set& other) noexcept
+{
+    using std::swap;
+    swap(m_keys, other.m_keys);
+    swap(m_comp, other.m_comp);
+    if constexpr (use_eytzinger)
+    {
+        swap(m_index.keys, other.m_index.keys);
+    }
+}
+
+template< class Key, class Compare, class Container, class Layout >
+Container flat_set<Key, Compare, Container, Layout>::extract() &&
+{
+    Container keys = std::move(m_keys);
+    clear();
+    return keys;
+}
+
+template< class Key, class Compare, class Container, class Layout >
+typename flat_set<Key, Compare, Container, Layout>::iterator flat_set<Key, Compare, Container, Layout>::find(const Key& key) const
+{
+    if constexpr (use_eytzinger)
+    {
+        // compare against the index copy, the rank is only needed on a hit
+        const size_type k = lower_bound_node(key);
+        if (k != 0 && !m_comp(key, m_index.keys[k - 1])) return begin() + node_rank(k);
+        return end();
+    }
+    else
+    {
+        size_type pos = lower_bound_index(key);
+        if (pos != m_keys.size() && !m_comp(key, m_keys[pos])) return begin() + pos;
+        return end();
+    }
+}
+
+template< class Key, class Compare, class Container, class Layout >
+typename flat_set<Key, Compare, Container, Layout>::iterator flat_set<Key, Compare, Container, Layout>::lower_bound(const Key& key) const
+{
+    return begin() + lower_bound_index(key);
+}
+
+template< class Key, class Compare, class Container, class Layout >
+typename flat_set<Key, Compare, Container, Layout>::iterator flat_set<Key, Compare, Container, Layout>::upper_bound(const Key& key) const
+{
+    size_type pos = lower_bound_index(key);
+    if (pos != m_keys.size() && !m_comp(key, m_keys[pos])) ++pos;
+    return begin() + pos;
+}
+
+template< class Key, class Compare, class Container, class Layout >
+typename flat_set<Key, Compare, Container, Layout>::size_type flat_set<Key, Compare, Container, Layout>::lower_bound_index(const Key& key) const
+{
+    const size_type n = m_keys.size();
+
+    if constexpr (use_eytzinger)
+    {
+        const size_type k = lower_bound_node(key);
+        return k == 0 ? n : node_rank(k);
+    }
+    else
+    {
+        if (n == 0) return 0;
+
+        // the halving does not depend on the comparison, which compiles to a conditional move
+        const Key* base = m_keys.data();
+        size_type length = n;
+        while (length > 1)
+        {
+            const size_type half = length / 2;
+            base = m_comp(base[half], key) ? base + half : base;
+            length -= half;
+        }
+        return static_cast<size_type>(base - m_keys.data()) + static_cast<size_type>(m_comp(*base, key));
+    }
+}
+
+// Node of the Eytzinger index holding the first key not below key, 0 if there is none
+template< class Key, class Compare, class Container, class Layout >
+typename flat_set<Key, Compare, Container, Layout>::size_type flat_set<Key, Compare, Container, Layout>::lower_bound_node(const Key& key) const
+{
+    const size_type n = m_keys.size();
+    const Key* keys = m_index.keys.data();
+
+    // descend to a leaf, going right while the probe is below key; the answer is the
+    // last node where we went left, found by dropping the trailing right turns
+    size_type k = 1;
+    while (k <= n)
+    {
+#if defined(__GNUC__)
+        if (16 * k <= n) __builtin_prefetch(keys + 16 * k - 1);
+#endif
+        k = 2 * k + static_cast<size_type>(m_comp(keys[k - 1], key));
+    }
+    return k >> (std::countr_one(k) + 1);
+}
+
+// Position among the sorted keys of an index node. In a perfect tree of h levels the node at
+// depth d and offset i within its level has rank (2i + 1) * 2^(h - 1 - d) - 1; the last level
+// is filled from the left, so subtract its missing leaves, which sit at the even ranks.
+template< class Key, class Compare, class Container, class Layout >
+typename flat_set<Key, Compare, Container, Layout>::size_type flat_set<Key, Compare, Container, Layout>::node_rank(size_type node) const noexcept
+{
+    const size_type n = m_keys.size();
+    const int height = std::bit_width(n);
+    const int depth = std::bit_width(node) - 1;
+
+    const size_type offset = node - (size_type(1) << depth);
+    const size_type perfect_rank = ((2 * offset + 1) << (height - 1 - depth)) - 1;
+
+    const size_type last_level = n - ((size_type(1) << (height - 1)) - 1);
+    const size_type leaves_before = (perfect_rank + 1) / 2;
+    return leaves_before > last_level ? perfect_rank - (leaves_before - last_level) : perfect_rank;
+}
+
+template< class Key, class Compare, class Container, class Layout >
+void flat_set<Key, Compare, Container, Layout>::rebuild_index()
+{
+    m_index.keys.clear();
+    m_index.keys.reserve(m_keys.size());
+
+    // slots are written out of order, fill them with copies first
+    m_index.keys.insert(m_index.keys.cend(), m_keys.begin(), m_keys.end());
+
+    size_type next = 0;
+    fill_index(1, next);
+}
+
+// In-order walk of the implicit tree hands out the sorted keys in order
+template< class Key, class Compare, class Container, class Layout >
+void flat_set<Key, Compare, Container, Layout>::fill_index(size_type node, size_type& next)
+{
+    if (node > m_keys.size()) return;
+
+    fill_index(2 * node, next);
+    m_index.keys[node - 1] = m_keys[next++];
+    fill_index(2 * node + 1, next);
+}
+
+#endif //! OWN_FLAT_SET_H
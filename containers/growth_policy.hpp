@@ -0,0 +1,61 @@
+#ifndef OWN_GROWTH_POLICY_H
+#define OWN_GROWTH_POLICY_H
+
+// CXX20
+
+#include <bit>
+#include <cstddef>
+
+// A growth policy tells a contiguous container how large its next buffer should be.
+// next_capacity receives the current capacity, the size that has to fit and the element
+// size in bytes; the result is never smaller than the required size.
+
+template< std::size_t Num, std::size_t Den >
+struct geometric_growth
+{
+    static_assert(Den > 0 && Num > Den, "Growth factor must be greater than one");
+
+    static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t) noexcept
+    {
+        const std::size_t grown = capacity + capacity / Den * (Num - Den) + capacity % Den * (Num - Den) / Den;
+        return grown > required ? grown : required;
+    }
+};
+
+using growth_1_5x = geometric_growth<3, 2>;
+using growth_2x = geometric_growth<2, 1>;
+
+// Rounds buffers of a page or more up to whole pages, so large vectors use the memory
+// the allocator hands out anyway.
+template< class Base = growth_2x, std::size_t PageSize = 4096 >
+struct page_rounded_growth
+{
+    static_assert(std::has_single_bit(PageSize), "Page size must be a power of two");
+
+    static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t value_size) noexcept
+    {
+        const std::size_t count = Base::next_capacity(capacity, required, value_size);
+        const std::size_t bytes = count * value_size;
+        if (bytes < PageSize) return count;
+
+        return ((bytes + PageSize - 1) & ~(PageSize - 1)) / value_size;
+    }
+};
+
+// Rounds the byte size up to the next malloc size class (four classes per power of two,
+// as in jemalloc and tcmalloc), so the slack of the allocation becomes usable capacity.
+template< class Base = growth_2x >
+struct size_class_growth
+{
+    static constexpr std::size_t next_capacity(std::size_t capacity, std::size_t required, std::size_t value_size) noexcept
+    {
+        const std::size_t count = Base::next_capacity(capacity, required, value_size);
+        const std::size_t bytes = count * value_size;
+        if (bytes <= 16) return 16 / value_size > count ? 16 / value_size : count;
+
+        const std::size_t spacing = bytes <= 64 ? 16 : std::size_t(1) << (std::bit_width(bytes - 1) - 3);
+        return ((bytes + spacing - 1) & ~(spacing - 1)) / value_size;
+    }
+};
+
+#endif //! OWN_GROWTH_POLICY_H
@@ -12,8 +12,10 @@
 #include <initializer_list>
 #include <limits>
 
+#include "node_pool.hpp"
 
-template < class T, class Allocator = std::allocator<T> >
+
+template < class T, class Allocator = std::allocator<T>, class NodePool = per_container_pool >
 class list
 {
 private:
@@ -57,7 +59,8 @@ public:
 
 	// assignment operator
 	list& operator=( const list& other );
-	list& operator=( list&& other ) noexcept;
+	list& operator=( list&& other )
+		noexcept(node_allocator_traits::propagate_on_container_move_assignment::value || node_allocator_traits::is_always_equal::value);
 	list& operator=( std::initializer_list<value_type> ilist );
 
 	// assign methods
@@ -66,14 +69,14 @@ public:
 	void assign( InputIt first, InputIt last );
 	void assign( std::initializer_list<T> ilist );
 
-	allocator_type get_allocator() const noexcept { return m_alloc; }
+	allocator_type get_allocator() const noexcept { return allocator_type(m_alloc); }
 
 	// element access
-	reference front() { return m_head->value; }
-	const_reference front() const { return m_head->value; }
+	reference front() { return static_cast<node*>(fake_node.next)->value; }
+	const_reference front() const { return static_cast<const node*>(fake_node.next)->value; }
 
-	reference back() { return m_tail->value; }
-	const_reference back() const { return m_tail->value; }
+	reference back() { return static_cast<node*>(fake_node.prev)->value; }
+	const_reference back() const { return static_cast<const node*>(fake_node.prev)->value; }
 
 	// iterators
 	iterator begin() noexcept { return fake_node.next; }
@@ -93,10 +96,14 @@ public:
 	const_reverse_iterator crend() const noexcept { return const_reverse_iterator(const_cast<base_node*>(fake_node.next)); }
 
 	// capacity
-	bool empty() const noexcept { return size() == 0; }
-	size_type size() const noexcept { return std::distance(begin(), end()); }
+	bool empty() const noexcept { return m_size == 0; }
+	size_type size() const noexcept { return m_size; }
 	size_type max_size() const noexcept { return node_allocator_traits::max_size(m_alloc); }
 
+	// node pool; with per_container_pool each list has its own, and lists used on different
+	// threads never touch each other's even after splicing
+	node_pool_stats pool_stats() const noexcept { return m_pool ? m_pool->stats() : node_pool_stats{}; }
+
 	// modifiers
 	void clear();
 
@@ -136,20 +143,20 @@ public:
 
 	// operations
 	void merge( list& other ) { merge(other, std::less<T>()); }
-	void merge( list&& other ) { merge(std::move(other), std::less<T>()); }
+	void merge( list&& other ) { merge(other, std::less<T>()); }
 	template< class Compare >
 	void merge( list& other, Compare comp );
 	template< class Compare >
-	void merge( list&& other, Compare comp ) { merge(std::move(other), comp); }
+	void merge( list&& other, Compare comp ) { merge(other, comp); }
 
 	void splice( const_iterator pos, list& other );
-	void splice( const_iterator pos, list&& other ) { splice(pos, std::move(other)); }
+	void splice( const_iterator pos, list&& other ) { splice(pos, other); }
 	void splice( const_iterator pos, list& other, const_iterator it );
-	void splice( const_iterator pos, list&& other, const_iterator it ) { splice(pos, std::move(other), it); }
+	void splice( const_iterator pos, list&& other, const_iterator it ) { splice(pos, other, it); }
 	void splice( const_iterator pos, list& other,
         const_iterator first, const_iterator last);
 	void splice( const_iterator pos, list&& other,
-        const_iterator first, const_iterator last) { splice(pos, std::move(other), first, last); }
+        const_iterator first, const_iterator last) { splice(pos, other, first, last); }
 
 	size_type remove( const T& value );
 	template< class UnaryPredicate >
@@ -244,74 +251,64 @@ private:
 	void fill_list(size_type count, const T& value)
 	{
 		for (size_t i = 0; i < count; ++i)
-		{
-			node* new_node = create_node(value);
-
-			if (m_head == nullptr)
-			{
-				m_head = new_node;
-				m_tail = new_node;
-				m_head->next = &fake_node;
-				m_head->prev = &fake_node;
-				fake_node.next = m_head;
-				fake_node.prev = m_tail;
-			}
-
-			else
-			{
-				m_tail->next = new_node;
-				new_node->prev = m_tail;
-				new_node->next = &fake_node;
-				fake_node.prev = new_node;
-				m_tail = new_node;
-			}
-		}
+			insert_impl(end(), create_node(value));
 	}
 
 	template< std::input_iterator InputIt >
 	void fill_list(InputIt first, InputIt last)
 	{
 		for (; first != last; ++first)
-		{
-			node* new_node = create_node(*first);
-
-			if (m_head == nullptr)
-			{
-				m_head = new_node;
-				m_tail = new_node;
-				m_head->next = &fake_node;
-				m_head->prev = &fake_node;
-				fake_node.next = m_head;
-				fake_node.prev = m_tail;
-			}
-
-			else
-			{
-				m_tail->next = new_node;
-				new_node->prev = m_tail;
-				new_node->next = &fake_node;
-				fake_node.prev = new_node;
-				m_tail = new_node;
-			}
-			
-		}
+			insert_impl(end(), create_node(*first));
 	}
 
 	iterator insert_impl(const_iterator pos, node* new_node);
 
-	node* create_node(const T& value)
+	// Unlinks [first, last) and links it in front of pos; both may belong to any list
+	static void transfer(base_node* pos, base_node* first, base_node* last) noexcept
 	{
-		node* new_node = node_allocator_traits::allocate(m_alloc, 1);
-		node_allocator_traits::construct(m_alloc, new_node, value);
+		base_node* before_last = last->prev;
 
-		return new_node;
+		first->prev->next = last;
+		last->prev = first->prev;
+
+		first->prev = pos->prev;
+		before_last->next = pos;
+		pos->prev->next = first;
+		pos->prev = before_last;
+	}
+
+	// Moves other's whole chain of nodes into *this, which must be empty
+	void take_nodes(list& other) noexcept
+	{
+		if (other.fake_node.next == &other.fake_node) return;
+
+		fake_node.next = other.fake_node.next;
+		fake_node.prev = other.fake_node.prev;
+		fake_node.next->prev = &fake_node;
+		fake_node.prev->next = &fake_node;
+		m_size = other.m_size;
+
+		// the pool travels with its nodes; other starts a fresh one if it allocates again
+		m_pool = std::move(other.m_pool);
+
+		other.fake_node.next = &other.fake_node;
+		other.fake_node.prev = &other.fake_node;
+		other.m_size = 0;
 	}
 
 	template< class... Args >
 	node* create_node(Args&& ...args)
 	{
-		node* new_node = node_allocator_traits::allocate(m_alloc, 1);
-		node_allocator_traits::construct(m_alloc, new_node, std::forward<Args>(args)...);
+		node* new_node = allocate_node();
+		try
+		{
+			node_allocator_traits::construct(m_alloc, new_node, std::forward<Args>(args)...);
+		}
+		catch (...)
+		{
+			deallocate_node(new_node);
+			throw;
+		}
 
 		return new_node;
 	}
@@ -319,451 +316,394 @@ private:
 	void destroy_node(node* node)
 	{
 		node_allocator_traits::destroy(m_alloc, node);
-		node_allocator_traits::deallocate(m_alloc, node, 1);
+		deallocate_node(node);
 	}
-	
-	list split_before(const_iterator here)
-	{
-		list second_list;
 
-		return second_list.splice( second_list.begin(), *this, here, this->end() ) ;
+	node* allocate_node()
+	{
+		if constexpr (NodePool::enabled)
+		{
+			if (!m_pool) m_pool = NodePool::template acquire<pool_type>(m_alloc);
+			return m_pool->allocate();
+		}
+		else return node_allocator_traits::allocate(m_alloc, 1);
 	}
 
-	list split_after(const_iterator here)
+	void deallocate_node(node* node) noexcept
 	{
-		if( here == end() ) return {} ; // return empty list
-    	else return split_before( ++here ) ;
+		if constexpr (NodePool::enabled) m_pool->deallocate(node);
+		else node_allocator_traits::deallocate(m_alloc, node, 1);
 	}
 
-
-
+	// Nodes about to move in from other must keep their slabs alive as long as this list's
+	// pool; the pools themselves stay apart
+	void share_pool(list& other)
+	{
+		if constexpr (NodePool::enabled)
+		{
+			if (this == &other || !other.m_pool) return;
+			if (!m_pool) m_pool = NodePool::template acquire<pool_type>(m_alloc);
+			m_pool->adopt(*other.m_pool);
+		}
+	}
+	
+	// Merges the sorted chain b into the sorted chain a. Chains are null-terminated and linked
+	// through next only; among equal elements those of a come first. On return, or if comp
+	// throws, a holds every node of both chains and b is null.
 	template< class Compare >
-	void merge_sort(Compare comp, iterator first, iterator last)
+	static void merge_chains(base_node*& a, base_node*& b, Compare& comp)
 	{
-		if (size() < 2) return;
-		if (size() == 2)
+		base_node head;
+		base_node* tail = &head;
+		base_node* x = a;
+		base_node* y = b;
+
+		try
 		{
-			if (*first, *last)
+			while (x != nullptr && y != nullptr)
 			{
-				using std::swap;
-				swap(*first, *last);
+				if (comp(static_cast<node*>(y)->value, static_cast<node*>(x)->value)) { tail->next = y; y = y->next; }
+				else { tail->next = x; x = x->next; }
+				tail = tail->next;
 			}
 		}
+		catch (...)
+		{
+			tail->next = x;
+			while (tail->next != nullptr) tail = tail->next;
+			tail->next = y;
+			a = head.next;
+			b = nullptr;
+			throw;
+		}
 
-		auto middle_diff = std::distance(first, last) / 2;
-		auto middle = first;
-		std::advance(middle, middle_diff);		
-
-		list second_list;
-		second_list.splice(middle, *this);
+		tail->next = (x != nullptr) ? x : y;
+		a = head.next;
+		b = nullptr;
+	}
 
-		merge_sort(comp, first, last);
-		second_list.merge_sort(comp, second_list.begin(), second_list.end());
+	// Rebuilds prev links and the sentinel around a null-terminated chain linked through next
+	void relink(base_node* chain) noexcept
+	{
+		base_node* prev = &fake_node;
+		for (base_node* current = chain; current != nullptr; current = current->next)
+		{
+			current->prev = prev;
+			prev = current;
+		}
 
-		merge(second_list);
+		prev->next = &fake_node;
+		fake_node.prev = prev;
+		fake_node.next = (chain != nullptr) ? chain : &fake_node;
 	}
 
 	using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
 	using node_allocator_traits = typename std::allocator_traits<Allocator>::template rebind_traits<node>;
+	using pool_type = node_pool<node, node_allocator>;
 	
 	node_allocator m_alloc;
-	node* m_head = nullptr;
-	node* m_tail = nullptr;
+	std::shared_ptr<pool_type> m_pool;
 	base_node fake_node{ &fake_node, &fake_node };
+	size_type m_size = 0;
 };
 
-template <class T, class Allocator>
-inline list<T, Allocator>::list()
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::list()
 {
-	m_head = static_cast<node*>(&fake_node);
-	m_tail = static_cast<node*>(&fake_node);
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>::list(const Allocator& alloc) : m_alloc(alloc)
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::list(const Allocator& alloc) : m_alloc(alloc)
 {
-	m_head = static_cast<node*>(&fake_node);
-	m_tail = static_cast<node*>(&fake_node);
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>::list(size_type count, const T& value, const Allocator& alloc) : m_alloc(alloc)
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::list(size_type count, const T& value, const Allocator& alloc) : m_alloc(alloc)
 {
 	fill_list(count, value);
 }
 
-template <class T, class Allocator> 
-inline list<T, Allocator>::list(size_type count, const Allocator& alloc) : m_alloc(alloc)
+template <class T, class Allocator, class NodePool> 
+inline list<T, Allocator, NodePool>::list(size_type count, const Allocator& alloc) : m_alloc(alloc)
 {
 	fill_list(count, T());
 }
 
-template <class T, class Allocator>
+template <class T, class Allocator, class NodePool>
 template <std::input_iterator InputIt>
-inline list<T, Allocator>::list(InputIt first, InputIt last, const Allocator& alloc) : m_alloc(alloc)
+inline list<T, Allocator, NodePool>::list(InputIt first, InputIt last, const Allocator& alloc) : m_alloc(alloc)
 {
 	fill_list(first, last);
 }
 
-template<class T, class Allocator>
-inline list<T, Allocator>::list(const list& other)
+template<class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::list(const list& other)
+	: m_alloc(node_allocator_traits::select_on_container_copy_construction(other.m_alloc))
 {
-	m_alloc = node_allocator_traits::select_on_container_copy_construction(other.m_alloc);
 	fill_list(other.begin(), other.end());
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>::list(const list& other, const Allocator& alloc) : m_alloc(alloc)
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::list(const list& other, const Allocator& alloc) : m_alloc(alloc)
 {
 	fill_list(other.begin(), other.end());
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>::list(list&& other)
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::list(list&& other) : m_alloc(other.m_alloc)
 {
-	m_head = other.m_head;
-	m_tail = other.m_tail;
-	m_alloc = node_allocator_traits::select_on_container_copy_construction(std::move(other.m_alloc));
-
-	fake_node.next = m_head;
-	fake_node.prev = m_tail;
-
-	m_head->prev = &fake_node;
-	m_tail->next = &fake_node;
-
-	other.m_head = static_cast<node*>(&other.fake_node);
-	other.m_tail = static_cast<node*>(&other.fake_node);
-	other.m_head->prev = &other.fake_node;
-	other.m_tail->next = &other.fake_node;
+	take_nodes(other);
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>::list(list&& other, const Allocator& alloc) : m_alloc(alloc)
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::list(list&& other, const Allocator& alloc) : m_alloc(alloc)
 {
-	m_head = other.m_head;
-	m_tail = other.m_tail;
-	m_alloc = std::move(other.m_alloc);
-
-	fake_node.next = m_head;
-	fake_node.prev = m_tail;
-
-	m_head->prev = &fake_node;
-	m_tail->next = &fake_node;
-
-	other.m_head = static_cast<node*>(&other.fake_node);
-	other.m_tail = static_cast<node*>(&other.fake_node);
-	other.m_head->prev = &other.fake_node;
-	other.m_tail->next = &other.fake_node;
+	if (m_alloc == other.m_alloc) take_nodes(other);
+	else
+	{
+		// nodes owned by another allocator cannot change hands, move the values instead
+		fill_list(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+		other.clear();
+	}
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>::list(std::initializer_list<T> init, const Allocator& alloc) : m_alloc(alloc)
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::list(std::initializer_list<T> init, const Allocator& alloc) : m_alloc(alloc)
 {
 	fill_list(init.begin(), init.end());
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>::~list()
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::~list()
 {
 	clear();
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>& list<T, Allocator>::operator=( const list& other )
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>& list<T, Allocator, NodePool>::operator=( const list& other )
 {
 	if (this == &other) return *this;
-	else
-	{
-		clear();
-		if (node_allocator_traits::propagate_on_container_copy_assignment)
-			m_alloc = other.m_alloc;
-		
-		fill_list(other.begin(), other.end());
-		return *this;
-	}
+
+	clear();
+	if constexpr (node_allocator_traits::propagate_on_container_copy_assignment::value)
+		m_alloc = other.m_alloc;
+
+	fill_list(other.begin(), other.end());
+	return *this;
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>& list<T, Allocator>::operator=( list&& other ) noexcept
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>& list<T, Allocator, NodePool>::operator=( list&& other )
+	noexcept(node_allocator_traits::propagate_on_container_move_assignment::value || node_allocator_traits::is_always_equal::value)
 {
 	if (this == &other) return *this;
+
+	clear();
+	if constexpr (node_allocator_traits::propagate_on_container_move_assignment::value)
+	{
+		m_alloc = std::move(other.m_alloc);
+		take_nodes(other);
+	}
+	else if (m_alloc == other.m_alloc) take_nodes(other);
 	else
 	{
-		clear();
-		if (node_allocator_traits::propagate_on_container_move_assignment)
-			m_alloc = std::move(other.m_alloc);
-		
-		m_head = other.m_head;
-		m_tail = other.m_tail;
-
-		fake_node.next = m_head;
-		other.m_tail = static_cast<node*>(&other.fake_node);
-		other.m_head->prev = &other.fake_node;
-		other.m_tail->next = &other.fake_node;
-
-		return *this;
+		fill_list(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+		other.clear();
 	}
+
+	return *this;
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>& list<T, Allocator>::operator=( std::initializer_list<value_type> ilist )
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>& list<T, Allocator, NodePool>::operator=( std::initializer_list<value_type> ilist )
 {
 	clear();
 	fill_list(ilist.begin(), ilist.end());
 	return *this;
 }
 
-template <class T, class Allocator>
-inline void list<T, Allocator>::assign(size_type count, const T& value)
+template <class T, class Allocator, class NodePool>
+inline void list<T, Allocator, NodePool>::assign(size_type count, const T& value)
 {
+	clear();
 	fill_list(count, value);
 }
 
-template <class T, class Allocator>
+template <class T, class Allocator, class NodePool>
 template <std::input_iterator InputIt>
-inline void list<T, Allocator>::assign(InputIt first, InputIt last)
+inline void list<T, Allocator, NodePool>::assign(InputIt first, InputIt last)
 {
+	clear();
 	fill_list(first, last);
 }
 
-template <class T, class Allocator>
-inline void list<T, Allocator>::assign(std::initializer_list<T> ilist)
+template <class T, class Allocator, class NodePool>
+inline void list<T, Allocator, NodePool>::assign(std::initializer_list<T> ilist)
 {
+	clear();
 	fill_list(ilist.begin(), ilist.end());
 }
 
-template<class T, class Allocator>
-inline void list<T, Allocator>::clear()
+template<class T, class Allocator, class NodePool>
+inline void list<T, Allocator, NodePool>::clear()
 {
-	node* current = m_head;
+	base_node* current = fake_node.next;
 	while (current != &fake_node)
 	{
-		node* next = static_cast<node*>(current->next);
-		destroy_node(current);
+		base_node* next = current->next;
+		destroy_node(static_cast<node*>(current));
 		current = next;
 	}
 
-	m_head = static_cast<node*>(&fake_node);
-	m_tail = static_cast<node*>(&fake_node);
 	fake_node.next = &fake_node;
 	fake_node.prev = &fake_node;
+	m_size = 0;
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>::iterator list<T, Allocator>::insert(const_iterator pos, size_type count, const T& value)
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::iterator list<T, Allocator, NodePool>::insert(const_iterator pos, size_type count, const T& value)
 {
-	node* new_node = nullptr;
+	iterator first(pos.m_node);
 
 	for (size_type i = 0; i < count; i++)
 	{
-		new_node = create_node(value);
-
-		if (pos == cend())
-		{
-			new_node->prev = m_tail;
-			new_node->next = &fake_node;
-			m_tail->next = new_node;
-			m_tail = new_node;
-		}
-		else
-		{
-			node* pos_node = static_cast<node*>(pos.m_node);
-			node* prev_pos_node = static_cast<node*>(pos.m_node->prev);
-
-			pos_node->prev = new_node;
-			new_node->next = pos_node;
-
-			prev_pos_node->next = new_node;
-			new_node->prev = prev_pos_node;
-		}
+		iterator it = insert_impl(pos, create_node(value));
+		if (i == 0) first = it;
 	}
-	return iterator(new_node);
+	return first;
 }
 
-template <class T, class Allocator>
+template <class T, class Allocator, class NodePool>
 template <std::input_iterator InputIt>
-inline list<T, Allocator>::iterator list<T, Allocator>::insert(const_iterator pos, InputIt first, InputIt last)
+inline list<T, Allocator, NodePool>::iterator list<T, Allocator, NodePool>::insert(const_iterator pos, InputIt first, InputIt last)
 {
-    node* new_node = nullptr;
+	iterator result(pos.m_node);
+	bool inserted = false;
 
 	for (; first != last; ++first)
 	{
-		new_node = create_node(*first);
-
-		if (pos == cend())
-		{
-			new_node->prev = m_tail;
-			new_node->next = &fake_node;
-			m_tail->next = new_node;
-			m_tail = new_node;
-		}
-		else
-		{
-			node* pos_node = static_cast<node*>(pos.m_node);
-			node* prev_pos_node = static_cast<node*>(pos.m_node->prev);
-
-			pos_node->prev = new_node;
-			new_node->next = pos_node;
-
-			prev_pos_node->next = new_node;
-			new_node->prev = prev_pos_node;
-		}
+		iterator it = insert_impl(pos, create_node(*first));
+		if (!inserted) result = it;
+		inserted = true;
 	}
-	return iterator(new_node);
+	return result;
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>::iterator list<T, Allocator>::insert_impl(const_iterator pos, node* new_node)
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::iterator list<T, Allocator, NodePool>::insert_impl(const_iterator pos, node* new_node)
 {
-	node* prev = (pos == end()) ? m_tail : static_cast<node*>(pos.m_node->prev);
-	node* next = (pos == end()) ? static_cast<node*>(&fake_node) : static_cast<node*>(pos.m_node);
+	base_node* next = pos.m_node;
+	base_node* prev = next->prev;
 
 	new_node->prev = prev;
-	if (prev) prev->next = new_node;
-
 	new_node->next = next;
-	if (next) next->prev = new_node;
-
-	if (prev == m_tail) m_tail = new_node;
-	if (next == m_head) m_head = new_node;
+	prev->next = new_node;
+	next->prev = new_node;
+	++m_size;
 
 	return iterator(new_node);
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>::iterator list<T, Allocator>::erase(const_iterator pos)
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::iterator list<T, Allocator, NodePool>::erase(const_iterator pos)
 {
     if (pos == cend())
 	{
 		return end();
 	}
 
-	else if (pos == cbegin())
-	{
-		node* current = static_cast<node*>(pos.m_node);
-		node* next = static_cast<node*>(pos.m_node->next);
-
-		fake_node.next = next;
-		next->prev = &fake_node;
-
-		m_head = static_cast<node*>(next->prev);
-
-		destroy_node(current);
-
-		return iterator(next);
-	}
-
-	node* current = static_cast<node*>(pos.m_node);
-	node* next = static_cast<node*>(pos.m_node->next);
-	node* prev = static_cast<node*>(pos.m_node->prev);
+	base_node* current = pos.m_node;
+	base_node* next = current->next;
 
-	prev->next = next;
-	next->prev = prev;
+	current->prev->next = next;
+	next->prev = current->prev;
 
-	destroy_node(current);
+	destroy_node(static_cast<node*>(current));
+	--m_size;
 
 	return iterator(next);
 }
 
-template <class T, class Allocator>
-inline list<T, Allocator>::iterator list<T, Allocator>::erase(const_iterator first, const_iterator last)
+template <class T, class Allocator, class NodePool>
+inline list<T, Allocator, NodePool>::iterator list<T, Allocator, NodePool>::erase(const_iterator first, const_iterator last)
 {
-    node* first_node = static_cast<node*>(first.m_node);
-	node* last_node = static_cast<node*>(last.m_node);
+	base_node* current = first.m_node;
 
-	while (first_node != last_node)
+	while (current != last.m_node)
 	{
-		node* next_node = static_cast<node*>(first_node->next);
-		node* prev_node = static_cast<node*>(first_node->prev);
+		base_node* next = current->next;
 
-		prev_node->next = next_node;
-		next_node->prev = prev_node;
+		current->prev->next = next;
+		next->prev = current->prev;
 
-		node* current = first_node;
-		first_node = next_node;
+		destroy_node(static_cast<node*>(current));
+		--m_size;
 
-		destroy_node(current);
+		current = next;
 	}
 
-	return iterator(last_node);
+	return iterator(last.m_node);
 }
 
-template <class T, class Allocator>
+template <class T, class Allocator, class NodePool>
 template <class... Args>
-inline list<T, Allocator>::reference list<T, Allocator>::emplace_back(Args&&... args)
+inline list<T, Allocator, NodePool>::reference list<T, Allocator, NodePool>::emplace_back(Args&&... args)
 {
 	insert_impl(end(), create_node(std::forward<Args>(args)...));
-	return m_tail->value;
+	return back();
 }
 
-template <class T, class Allocator>
+template <class T, class Allocator, class NodePool>
 template <class... Args>
-inline list<T, Allocator>::reference list<T, Allocator>::emplace_front(Args&&... args)
+inline list<T, Allocator, NodePool>::reference list<T, Allocator, NodePool>::emplace_front(Args&&... args)
 {
     insert_impl(begin(), create_node(std::forward<Args>(args)...));
-	return m_head->value;
+	return front();
 }
 
-template <class T, class Allocator>
-inline void list<T, Allocator>::pop_back()
+template <class T, class Allocator, class NodePool>
+inline void list<T, Allocator, NodePool>::pop_back()
 {
 	if (empty()) return;
 
-	node* prev = static_cast<node*>(m_tail->prev);
-	node* next = static_cast<node*>(m_tail->next);
-
-	destroy_node(m_tail);
-
-	prev->next = next;
-	next->prev = prev;
-
+	erase(const_iterator(fake_node.prev));
 }
 
-template <class T, class Allocator>
-inline void list<T, Allocator>::pop_front()
+template <class T, class Allocator, class NodePool>
+inline void list<T, Allocator, NodePool>::pop_front()
 {
 	if (empty()) return;
 
-	node* current = m_head;
-	node* next = static_cast<node*>(current->next);
-
-	fake_node.next = next;
-	next->prev = &fake_node;
-
-	m_head = next;
-
-	destroy_node(current);
+	erase(cbegin());
 }
 
-template <class T, class Allocator>
-inline void list<T, Allocator>::resize(size_type count, const value_type& value)
+template <class T, class Allocator, class NodePool>
+inline void list<T, Allocator, NodePool>::resize(size_type count, const value_type& value)
 {	
-	if (empty()) fill_list(count, value);
-	if (count == size()) return;
-
-	if (size() < count) insert_impl(cend(), create_node(value));
-	if (size() > count) 
-	{
-		for (size_t i = 0; i < abs(size() - count); i++)
-			pop_back();
-	}
+	while (m_size > count) pop_back();
+	while (m_size < count) insert_impl(cend(), create_node(value));
 }
 
-template< class T, class Allocator >
-inline void list<T, Allocator>::swap(list& other) noexcept
+template< class T, class Allocator, class NodePool >
+inline void list<T, Allocator, NodePool>::swap(list& other) noexcept
 {
-	if (node_allocator_traits::propagate_on_container_swap::value)
-		std::swap(m_alloc, other.m_alloc);
+	if (this == &other) return;
 
-	using std::swap;
-	swap(&fake_node, &other.fake_node);
-	swap(m_head->prev, other.m_head->prev);
-	swap(m_tail->next, other.m_tail->next);
+	if constexpr (node_allocator_traits::propagate_on_container_swap::value)
+	{
+		using std::swap;
+		swap(m_alloc, other.m_alloc);
+	}
+
+	list tmp(get_allocator());
+	tmp.take_nodes(*this);
+	take_nodes(other);
+	other.take_nodes(tmp);
 }
 
-template<class T, class Allocator>
+template<class T, class Allocator, class NodePool>
 template<class Compare>
-inline void list<T, Allocator>::merge(list& other, Compare comp)
+inline void list<T, Allocator, NodePool>::merge(list& other, Compare comp)
 {
 	if (this == &other) return;
 	if (other.empty()) return;
@@ -783,123 +723,51 @@ inline void list<T, Allocator>::merge(list& other, Compare comp)
 	}
 }
 
-template< class T, class Allocator >
-inline void list<T, Allocator>::splice(const_iterator pos, list& other)
+template< class T, class Allocator, class NodePool >
+inline void list<T, Allocator, NodePool>::splice(const_iterator pos, list& other)
 {
-	if (other.empty()) return;
-	
-	node* pos_node = static_cast<node*>(pos.m_node);
-	node* prev_pos_node = static_cast<node*>(pos.m_node->prev);
+	if (this == &other || other.empty()) return;
+	share_pool(other);
 
-	node* first_node = other.m_head;
-	node* last_node = other.m_tail;
-
-	pos_node->prev = last_node;
-	last_node->next = pos_node;
-
-	prev_pos_node->next = first_node;
-	first_node->prev = prev_pos_node;
-
-	other.m_head = static_cast<node*>(&other.fake_node);
-	other.m_tail = static_cast<node*>(&other.fake_node);
-	other.m_head->prev = &other.fake_node;
-	other.m_tail->next = &other.fake_node;
+	transfer(pos.m_node, other.fake_node.next, &other.fake_node);
+	m_size += other.m_size;
+	other.m_size = 0;
 }
 
-template< class T, class Allocator >
-inline void list<T, Allocator>::splice(const_iterator pos, list& other, const_iterator it)
+template< class T, class Allocator, class NodePool >
+inline void list<T, Allocator, NodePool>::splice(const_iterator pos, list& other, const_iterator it)
 {
-	node* pos_node = static_cast<node*>(pos.m_node);
-	node* prev_pos_node = static_cast<node*>(pos.m_node->prev);
-
-	node* other_it_node = static_cast<node*>(it.m_node);
-
-	if (it == other.cbegin())
-	{
-		node* next_other_it_node = static_cast<node*>(other.m_head->next);
-		node* prev_other_it_node = static_cast<node*>(&other.fake_node);
-
-		pos_node->prev = other_it_node;
-		other_it_node->next = pos_node;
-
-		prev_pos_node->next = other_it_node;
-		other_it_node->prev = prev_pos_node;
-
-		next_other_it_node->prev = &other.fake_node;
-		other.fake_node.next = next_other_it_node;
-
-		other.m_head = next_other_it_node;
-	}
+	base_node* next = it.m_node->next;
+	if (pos.m_node == it.m_node || pos.m_node == next) return;
+	share_pool(other);
 
-	else
+	transfer(pos.m_node, it.m_node, next);
+	if (this != &other)
 	{
-		node* next_other_it_node = static_cast<node*>(it.m_node->next);
-		node* prev_other_it_node = static_cast<node*>(it.m_node->prev);
-
-		pos_node->prev = other_it_node;
-		other_it_node->next = pos_node;
-
-		prev_pos_node->next = other_it_node;
-		other_it_node->prev = prev_pos_node;
-
-		next_other_it_node->prev = prev_other_it_node;
-		prev_other_it_node->next = next_other_it_node;
+		++m_size;
+		--other.m_size;
 	}
 }
 
-template< class T, class Allocator >
-inline void list<T, Allocator>::splice(const_iterator pos, list& other, const_iterator first, const_iterator last)
+template< class T, class Allocator, class NodePool >
+inline void list<T, Allocator, NodePool>::splice(const_iterator pos, list& other, const_iterator first, const_iterator last)
 {
 	if (first == last) return;
 
-	if (first == other.cbegin())
-	{
-		node* prev_pos_node = static_cast<node*>(pos.m_node->prev);
-		node* pos_node = static_cast<node*>(pos.m_node);
-
-		node* prev_first_node = static_cast<node*>(&other.fake_node);
-		node* first_node = static_cast<node*>(other.m_head);
-
-		node* prev_last_node = static_cast<node*>(last.m_node->prev);
-		node* last_node = static_cast<node*>(last.m_node);
-
-		prev_first_node->next = last_node;
-		last_node->prev = prev_first_node;
-
-		prev_last_node->next = pos_node;
-		first_node->prev = prev_pos_node;
-		prev_pos_node->next = first_node;
-		pos_node->prev = prev_last_node;
-
-		last_node->prev = &other.fake_node;
-		other.fake_node.next = last_node;
-		other.m_head = last_node;
-	}
-
-	else
+	// only a transfer between two lists changes the counts and has to walk the range
+	if (this != &other)
 	{
-		node* prev_pos_node = static_cast<node*>(pos.m_node->prev);
-		node* pos_node = static_cast<node*>(pos.m_node);
-
-		node* prev_first_node = static_cast<node*>(first.m_node->prev);
-		node* first_node = static_cast<node*>(first.m_node);
-
-		node* prev_last_node = static_cast<node*>(last.m_node->prev);
-		node* last_node = static_cast<node*>(last.m_node);
-
-		prev_first_node->next = last_node;
-		last_node->prev = prev_first_node;
-
-		prev_last_node->next = pos_node;
-		first_node->prev = prev_pos_node;
-		prev_pos_node->next = first_node;
-		pos_node->prev = prev_last_node;
+		share_pool(other);
+		size_type count = std::distance(first, last);
+		m_size += count;
+		other.m_size -= count;
 	}
 
+	transfer(pos.m_node, first.m_node, last.m_node);
 }
 
-template< class T, class Allocator >
-inline list<T, Allocator>::size_type list<T, Allocator>::remove(const T& value)
+template< class T, class Allocator, class NodePool >
+inline list<T, Allocator, NodePool>::size_type list<T, Allocator, NodePool>::remove(const T& value)
 {
 	size_type counter = 0;
 
@@ -915,9 +783,9 @@ inline list<T, Allocator>::size_type list<T, Allocator>::remove(const T& value)
 	return counter;
 }
 
-template< class T, class Allocator >
+template< class T, class Allocator, class NodePool >
 template< class UnaryPredicate >
-inline list<T, Allocator>::size_type list<T, Allocator>::remove_if(UnaryPredicate p)
+inline list<T, Allocator, NodePool>::size_type list<T, Allocator, NodePool>::remove_if(UnaryPredicate p)
 {
 	size_type counter = 0;
 
@@ -933,31 +801,19 @@ inline list<T, Allocator>::size_type list<T, Allocator>::remove_if(UnaryPredicat
 	return counter;
 }
 
-template< class T, class Allocator >
-inline void list<T, Allocator>::reverse() noexcept
+template< class T, class Allocator, class NodePool >
+inline void list<T, Allocator, NodePool>::reverse() noexcept
 {
-	if (m_head == &fake_node || m_head->next == &fake_node) return;
-
-	base_node* prev = nullptr;
-	base_node* current = m_head;
-	base_node* next = nullptr;
-
-	m_tail = m_head;
-
-	while (current != nullptr)
+	base_node* current = &fake_node;
+	do
 	{
-		next = current->next;
-		current->next = prev;
-		current->prev = next;
-		prev = current;
-		current = next;
-	}
-
-	m_head = static_cast<node*>(prev);
+		std::swap(current->next, current->prev);
+		current = current->prev;
+	} while (current != &fake_node);
 }
 
-template< class T, class Allocator >
-inline list<T, Allocator>::size_type list<T, Allocator>::unique()
+template< class T, class Allocator, class NodePool >
+inline list<T, Allocator, NodePool>::size_type list<T, Allocator, NodePool>::unique()
 {
 	return unique(
 		[](const auto& lhs, const auto& rhs)
@@ -967,9 +823,9 @@ inline list<T, Allocator>::size_type list<T, Allocator>::unique()
 	);
 }
 
-template< class T, class Allocator >
+template< class T, class Allocator, class NodePool >
 template< class BinaryPredicate >
-inline list<T, Allocator>::size_type list<T, Allocator>::unique(BinaryPredicate p)
+inline list<T, Allocator, NodePool>::size_type list<T, Allocator, NodePool>::unique(BinaryPredicate p)
 {
 	if (empty()) return 0;
 
@@ -990,11 +846,68 @@ inline list<T, Allocator>::size_type list<T, Allocator>::unique(BinaryPredicate
 	return counter;
 }
 
-template< class T, class Allocator >
+template< class T, class Allocator, class NodePool >
 template< class Compare >
-inline void list<T, Allocator>::sort(Compare comp) 
+inline void list<T, Allocator, NodePool>::sort(Compare comp) 
 {
-	merge_sort(comp, begin(), --end());
+	if (fake_node.next == fake_node.prev) return;
+
+	// bottom-up merge sort on the links: bins[i] is empty or holds a sorted run of 2^i nodes,
+	// and higher bins hold earlier elements
+	base_node* bins[64] = {};
+	base_node* run = nullptr;
+	base_node* current = fake_node.next;
+	fake_node.prev->next = nullptr;
+
+	try
+	{
+		while (current != nullptr)
+		{
+			run = current;
+			current = current->next;
+			run->next = nullptr;
+
+			size_t i = 0;
+			for (; bins[i] != nullptr; ++i)
+			{
+				merge_chains(bins[i], run, comp);
+				std::swap(run, bins[i]);
+			}
+			std::swap(run, bins[i]);
+		}
+
+		for (auto& bin : bins)
+		{
+			if (bin == nullptr) continue;
+			merge_chains(bin, run, comp);
+			std::swap(run, bin);
+		}
+	}
+	catch (...)
+	{
+		// put every node back, order unspecified
+		for (auto& bin : bins)
+		{
+			if (bin == nullptr) continue;
+			base_node* last = bin;
+			while (last->next != nullptr) last = last->next;
+			last->next = run;
+			run = bin;
+		}
+
+		base_node* last = run;
+		if (last != nullptr)
+		{
+			while (last->next != nullptr) last = last->next;
+			last->next = current;
+		}
+		else run = current;
+
+		relink(run);
+		throw;
+	}
+
+	relink(run);
 }
 
 #endif // !STL_HEADER_CXX20
@@ -0,0 +1,195 @@
+#ifndef OWN_NODE_POOL_H
+#define OWN_NODE_POOL_H
+
+// CXX20
+
+#include <new>
+#include <memory>
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+struct node_pool_stats
+{
+    std::size_t allocations = 0;    // nodes handed out
+    std::size_t hits = 0;           // of those, served from recycled nodes
+    std::size_t slabs = 0;          // blocks requested from the allocator
+    std::size_t capacity = 0;       // nodes in all slabs
+
+    double hit_rate() const noexcept { return allocations ? static_cast<double>(hits) / allocations : 0.0; }
+};
+
+// Hands out Node-sized slots from contiguous slabs obtained through NodeAllocator and keeps
+// freed slots on an intrusive free list.
+//
+// Containers hold the pool through a shared_ptr, and the slabs live in a store the pool holds
+// the same way. When nodes move from one container to another (splice, merge) the receiving
+// pool takes a reference to every store the giving pool depends on, so each node's storage
+// outlives all pools that may still free it. The free list and the bump range stay with their
+// pool: two containers never allocate from the same pool unless their policy shares it.
+// A slab is returned once the last pool referring to its store dies.
+template< class Node, class NodeAllocator >
+class node_pool
+{
+private:
+    using node_allocator_traits = std::allocator_traits<NodeAllocator>;
+
+    struct free_slot
+    {
+        free_slot* next;
+    };
+
+    // Lives in the first slot of every slab
+    struct slab_header
+    {
+        slab_header* next;
+        std::size_t count;
+    };
+
+    static_assert(sizeof(Node) >= sizeof(slab_header), "Node is too small to be pooled");
+
+    // Owns the slabs one pool carved; only that pool adds to it
+    struct slab_store
+    {
+        explicit slab_store(const NodeAllocator& alloc) noexcept : alloc(alloc) {}
+
+        slab_store(const slab_store&) = delete;
+        slab_store& operator=(const slab_store&) = delete;
+
+        ~slab_store()
+        {
+            while (slabs != nullptr)
+            {
+                slab_header* next = slabs->next;
+                node_allocator_traits::deallocate(alloc, reinterpret_cast<Node*>(slabs), slabs->count);
+                slabs = next;
+            }
+        }
+
+        NodeAllocator alloc;
+        slab_header* slabs = nullptr;
+    };
+
+    using store_handle = std::shared_ptr<slab_store>;
+    using store_list = std::vector<store_handle, typename node_allocator_traits::template rebind_alloc<store_handle>>;
+
+public:
+    explicit node_pool(const NodeAllocator& alloc) noexcept : m_alloc(alloc), m_borrowed(alloc) {}
+
+    node_pool(const node_pool&) = delete;
+    node_pool& operator=(const node_pool&) = delete;
+
+    // Raw storage for one Node; the caller constructs it
+    Node* allocate()
+    {
+        ++m_stats.allocations;
+
+        if (m_free != nullptr)
+        {
+            ++m_stats.hits;
+            free_slot* slot = m_free;
+            m_free = slot->next;
+            return reinterpret_cast<Node*>(slot);
+        }
+
+        if (m_bump == m_bump_end) grow();
+        return m_bump++;
+    }
+
+    // Takes back the storage of an already destroyed Node, which may come from any store
+    // this pool keeps alive
+    void deallocate(Node* node) noexcept
+    {
+        m_free = ::new (static_cast<void*>(node)) free_slot{ m_free };
+    }
+
+    const node_pool_stats& stats() const noexcept { return m_stats; }
+
+    // Keeps the slabs behind donor's nodes alive as long as this pool, before those nodes
+    // move into this pool's container. donor's free list and bump range stay with donor.
+    void adopt(const node_pool& donor)
+    {
+        if (&donor == this) return;
+
+        keep(donor.m_store);
+        for (const store_handle& store : donor.m_borrowed) keep(store);
+    }
+
+private:
+    void grow()
+    {
+        if (!m_store) m_store = std::allocate_shared<slab_store>(m_alloc, m_alloc);
+
+        const std::size_t count = m_next_slab;
+        Node* slab = node_allocator_traits::allocate(m_alloc, count);
+
+        m_store->slabs = ::new (static_cast<void*>(slab)) slab_header{ m_store->slabs, count };
+        m_bump = slab + 1;
+        m_bump_end = slab + count;
+
+        ++m_stats.slabs;
+        m_stats.capacity += count - 1;
+        if (m_next_slab < max_slab) m_next_slab *= 2;
+    }
+
+    void keep(const store_handle& store)
+    {
+        if (!store || store == m_store) return;
+        if (std::find(m_borrowed.begin(), m_borrowed.end(), store) != m_borrowed.end()) return;
+
+        m_borrowed.push_back(store);
+    }
+
+    static constexpr std::size_t max_slab = 1024;
+
+    NodeAllocator m_alloc;
+    store_handle m_store;       // slabs this pool carves, created with the first one
+    store_list m_borrowed;      // stores of pools whose nodes moved into this one's container
+    free_slot* m_free = nullptr;
+    Node* m_bump = nullptr;
+    Node* m_bump_end = nullptr;
+    std::size_t m_next_slab = 16;
+    node_pool_stats m_stats;
+};
+
+// Pooling policies for node-based containers
+
+// Every node comes straight from the allocator
+struct no_node_pool
+{
+    static constexpr bool enabled = false;
+};
+
+// Each container owns its pool, created on the first insertion
+struct per_container_pool
+{
+    static constexpr bool enabled = true;
+
+    template< class Pool, class NodeAllocator >
+    static std::shared_ptr<Pool> acquire(const NodeAllocator& alloc)
+    {
+        return std::allocate_shared<Pool>(alloc, alloc);
+    }
+};
+
+// All containers of one node type on a thread share a pool, which is not synchronized.
+// Containers keep the pool alive past the thread's exit, but a container built on one thread
+// must not allocate or free nodes on another (inserting, erasing, clearing, destruction),
+// nor splice with a container of another thread.
+struct thread_local_pool
+{
+    static constexpr bool enabled = true;
+
+    template< class Pool, class NodeAllocator >
+    static std::shared_ptr<Pool> acquire(const NodeAllocator&)
+    {
+        static_assert(std::allocator_traits<NodeAllocator>::is_always_equal::value,
+                      "A shared pool needs an allocator whose instances are interchangeable");
+
+        static thread_local std::shared_ptr<Pool> pool = std::make_shared<Pool>(NodeAllocator());
+        return pool;
+    }
+};
+
+#endif //! OWN_NODE_POOL_H
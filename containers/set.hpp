@@ -7,12 +7,21 @@
 #include <cstddef>
 #include <concepts>
 #include <iterator>
+#include <ranges>
 #include <utility>
 #include <initializer_list>
 #include <cmath>
+#include <vector>
+#include <future>
+#include <system_error>
 
+#include "node_pool.hpp"
 
-template< class Key >
+
+// OrderStatistics keeps subtree sizes in every node for find_by_order, order_of_key and
+// O(log n) iterator differences, at the cost of one size_type per node
+template< class Key, class Compare = std::less<Key>, class Allocator = std::allocator<Key>,
+    class NodePool = per_container_pool, bool OrderStatistics = false >
 class set
 {
 private:
@@ -20,13 +29,18 @@ private:
     struct base_node;
     struct avl_node;
 
+    // lookups take any type comparable with Key when Compare declares is_transparent
+    static constexpr bool transparent_compare = requires { typename Compare::is_transparent; };
+
 
 public:
     using key_type = Key;
     using value_type = Key;
     using size_type = size_t;
     using difference_type = std::ptrdiff_t;
-    using Compare = std::less<Key>;
+    using key_compare = Compare;
+    using value_compare = Compare;
+    using allocator_type = Allocator;
     using reference = Key&;
     using const_reference = const Key&;
     using pointer = Key*;
@@ -38,16 +52,26 @@ public:
 public:
     // constructors and destructor
     set() : fake_node(nullptr), m_size(0ull) {}
+    explicit set( const Compare& comp, const Allocator& alloc = Allocator() )
+        : fake_node(nullptr), m_size(0ull), m_comp(comp), m_alloc(alloc) {}
+    explicit set( const Allocator& alloc ) : fake_node(nullptr), m_size(0ull), m_alloc(alloc) {}
     template< std::input_iterator InputIt >
-    set( InputIt first, InputIt last);
+    set( InputIt first, InputIt last, 
+        const Compare& comp = Compare(), const Allocator& alloc = Allocator() );
     set( const set& other );
-    set( std::initializer_list<value_type> init );
+    set( set&& other ) noexcept;
+    set( std::initializer_list<value_type> init, 
+        const Compare& comp = Compare(), const Allocator& alloc = Allocator() );
     ~set() { clear(); }
 
     // assignment operators
     set& operator=( const set& other );
+    set& operator=( set&& other )
+        noexcept(node_allocator_traits::propagate_on_container_move_assignment::value || node_allocator_traits::is_always_equal::value);
     set& operator=( std::initializer_list<value_type> ilist );
 
+    allocator_type get_allocator() const noexcept { return allocator_type(m_alloc); }
+
     // iterators
     iterator begin();
     const_iterator begin() const;
@@ -59,28 +83,112 @@ public:
 
     // capacity
     bool empty() const noexcept { return m_size == 0ull; }
-    size_type size() const { std::distance(begin(), end()); }
+    size_type size() const noexcept { return m_size; }
 
     // modifiers
     void clear();
 
-    std::pair<iterator, bool> insert( const value_type& key );
-    std::pair<iterator, bool> insert( value_type&& key );
+    std::pair<iterator, bool> insert( const value_type& key ) { return insert_at(find_insert_position(key), key); }
+    std::pair<iterator, bool> insert( value_type&& key ) { return insert_at(find_insert_position(key), std::move(key)); }
+
+    // hint is the element the key should precede; when it is right the key is linked
+    // in without a search, so feeding sorted keys with hint end() is O(1) amortized
+    iterator insert( const_iterator hint, const value_type& key ) { return insert_at(hint_position(hint.m_node, key), key).first; }
+    iterator insert( const_iterator hint, value_type&& key ) { return insert_at(hint_position(hint.m_node, key), std::move(key)).first; }
+
+    template< class... Args >
+    std::pair<iterator, bool> emplace( Args&&... args );
+    template< class... Args >
+    iterator emplace_hint( const_iterator hint, Args&&... args );
 
     iterator erase( const_iterator pos );
 
+    // set algebra by splitting and joining trees, O(m log(n/m + 1)) for sizes m <= n.
+    // source is left empty; with equal allocators its nodes are reused rather than copied,
+    // while source keeps its own node pool, so both sets stay usable from different threads.
+    // threads > 1 spreads large inputs over up to that many threads, comp must then be
+    // safe to call concurrently. If comp throws, *this is left with the keys of both sets
+    // and source empty; keys are only lost if comp throws again while they are put back.
+    void merge( set&& source, unsigned threads = 1 );
+    void intersect( set&& source, unsigned threads = 1 );
+    void subtract( set&& source, unsigned threads = 1 );
+
     // lookup
-    iterator find( const value_type& key );
-    const_iterator find( const value_type& key ) const;
+    iterator find( const value_type& key ) { return iterator(find_node(key)); }
+    const_iterator find( const value_type& key ) const { return const_iterator(find_node(key)); }
+    template< class K > requires transparent_compare
+    iterator find( const K& key ) { return iterator(find_node(key)); }
+    template< class K > requires transparent_compare
+    const_iterator find( const K& key ) const { return const_iterator(find_node(key)); }
+
+    bool contains( const value_type& key ) const { return find_node(key) != &fake_node; }
+    template< class K > requires transparent_compare
+    bool contains( const K& key ) const { return find_node(key) != &fake_node; }
+
+    size_type count( const value_type& key ) const { return contains(key) ? 1 : 0; }
+    template< class K > requires transparent_compare
+    size_type count( const K& key ) const { return contains(key) ? 1 : 0; }
+
+    iterator lower_bound( const value_type& key ) { return iterator(lower_bound_node(key)); }
+    const_iterator lower_bound( const value_type& key ) const { return const_iterator(lower_bound_node(key)); }
+    template< class K > requires transparent_compare
+    iterator lower_bound( const K& key ) { return iterator(lower_bound_node(key)); }
+    template< class K > requires transparent_compare
+    const_iterator lower_bound( const K& key ) const { return const_iterator(lower_bound_node(key)); }
+
+    iterator upper_bound( const value_type& key ) { return iterator(upper_bound_node(key)); }
+    const_iterator upper_bound( const value_type& key ) const { return const_iterator(upper_bound_node(key)); }
+    template< class K > requires transparent_compare
+    iterator upper_bound( const K& key ) { return iterator(upper_bound_node(key)); }
+    template< class K > requires transparent_compare
+    const_iterator upper_bound( const K& key ) const { return const_iterator(upper_bound_node(key)); }
+
+    std::pair<iterator, iterator> equal_range( const value_type& key ) { return equal_range_impl<iterator>(key); }
+    std::pair<const_iterator, const_iterator> equal_range( const value_type& key ) const { return equal_range_impl<const_iterator>(key); }
+    template< class K > requires transparent_compare
+    std::pair<iterator, iterator> equal_range( const K& key ) { return equal_range_impl<iterator>(key); }
+    template< class K > requires transparent_compare
+    std::pair<const_iterator, const_iterator> equal_range( const K& key ) const { return equal_range_impl<const_iterator>(key); }
+
+    // the keys in [lo, hi) as a lazy view over the tree; valid until those nodes are erased
+    std::ranges::subrange<iterator> range( const value_type& lo, const value_type& hi ) const { return range_impl(lo, hi); }
+    template< class K > requires transparent_compare
+    std::ranges::subrange<iterator> range( const K& lo, const K& hi ) const { return range_impl(lo, hi); }
+
+    // find for each key of a batch sorted by key_comp(), end() where it is missing. Each search
+    // resumes from the previous result, so a batch of m keys costs O(m log(n/m + 1)) in total
+    template< std::ranges::input_range R >
+    std::vector<iterator> find_many( R&& sorted_keys ) const
+        requires std::convertible_to<std::ranges::range_reference_t<R>, const value_type&> || transparent_compare;
+
+    // observers
+    key_compare key_comp() const { return m_comp; }
+    value_compare value_comp() const { return m_comp; }
+
+    // order statistics
+    iterator find_by_order( size_type order ) requires OrderStatistics;
+    const_iterator find_by_order( size_type order ) const requires OrderStatistics;
+    size_type order_of_key( const value_type& key ) const requires OrderStatistics;
+
+    // node pool
+    node_pool_stats pool_stats() const noexcept { return m_pool ? m_pool->stats() : node_pool_stats{}; }
 
 
 private:
+    struct no_count
+    {
+        constexpr no_count( size_type ) noexcept {}
+    };
+
+    using count_type = std::conditional_t<OrderStatistics, size_type, no_count>;
+
     struct base_node
     {
         base_node* left;
         base_node* right;
         base_node* parent;
         char height;
+        [[no_unique_address]] count_type count{ 1 };    // nodes in this subtree
 
         base_node() : left(nullptr), right(nullptr), parent(nullptr), height(0) {}
         base_node( base_node* p ) : left(nullptr), right(nullptr), parent(p), height(0) {}
@@ -90,10 +198,8 @@ private:
     {
         Key key;
 
-        avl_node(const Key& _key, base_node* p) : key(_key), base_node(p) {}
-
         template< class... Args >
-        avl_node(Args&&... args, base_node* p) : key(std::forward< Args >(args)...), base_node(p) {}
+        avl_node(base_node* p, Args&&... args) : base_node(p), key(std::forward< Args >(args)...) {}
         friend class set;
     };
 
@@ -112,13 +218,17 @@ private:
         using iterator_category = std::bidirectional_iterator_tag;
 
     private:
-        tree_iter() = delete;
         tree_iter( base_node* node ) : m_node( node ) {}
 
-        base_node* m_node;
+        // a member, unlike the friend operator below, has access to set's private order_of
+        difference_type order() const noexcept { return static_cast<difference_type>(set::order_of(m_node)); }
+
+        base_node* m_node = nullptr;
 
     public:
+        tree_iter() = default;
         tree_iter( const tree_iter& other ) : m_node( other.m_node ) {}
+        tree_iter& operator = ( const tree_iter& other ) = default;
 
         reference operator * () const noexcept { return static_cast<avl_node*>( m_node )->key; } 
         pointer operator -> () const noexcept { return &static_cast<avl_node*>( m_node )->key; }
@@ -126,85 +236,347 @@ private:
         tree_iter& operator -- () { m_node = set::prev( m_node ); return *this; }
         tree_iter operator ++ (int) { tree_iter tmp = *this; ++(*this); return tmp; } 
         tree_iter operator -- (int) { tree_iter tmp = *this; --(*this); return tmp; } 
-        bool operator == ( const tree_iter& other ) { return m_node == other.m_node; }
-        bool operator != ( const tree_iter& other ) { return !(*this == other.m_node); }
+        bool operator == ( const tree_iter& other ) const { return m_node == other.m_node; }
+        bool operator != ( const tree_iter& other ) const { return !(*this == other); }
+
+        friend difference_type operator - ( const tree_iter& lhs, const tree_iter& rhs ) requires OrderStatistics
+        {
+            return lhs.order() - rhs.order();
+        }
     };
 
+    using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<avl_node>;
+    using node_allocator_traits = typename std::allocator_traits<Allocator>::template rebind_traits<avl_node>;
+    using pool_type = node_pool<avl_node, node_allocator>;
+
+    template< class... Args >
+    avl_node* create_node( base_node* parent, Args&&... args )
+    {
+        avl_node* new_node = allocate_node();
+        try
+        {
+            node_allocator_traits::construct(m_alloc, new_node, parent, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate_node(new_node);
+            throw;
+        }
+        return new_node;
+    }
+
+    void destroy_node( base_node* node )
+    {
+        avl_node* old_node = static_cast<avl_node*>(node);
+        node_allocator_traits::destroy(m_alloc, old_node);
+        deallocate_node(old_node);
+    }
+
+    avl_node* allocate_node()
+    {
+        if constexpr (NodePool::enabled)
+        {
+            if (!m_pool) m_pool = NodePool::template acquire<pool_type>(m_alloc);
+            return m_pool->allocate();
+        }
+        else return node_allocator_traits::allocate(m_alloc, 1);
+    }
+
+    void deallocate_node( avl_node* node ) noexcept
+    {
+        if constexpr (NodePool::enabled) m_pool->deallocate(node);
+        else node_allocator_traits::deallocate(m_alloc, node, 1);
+    }
+
     base_node fake_node;
-    size_type m_size;
+    base_node* m_leftmost = &fake_node;     // begin(), or &fake_node when empty
+    base_node* m_rightmost = &fake_node;    // last element, or &fake_node when empty
+    size_type m_size = 0ull;
+    Compare m_comp;
+    node_allocator m_alloc;
+    std::shared_ptr<pool_type> m_pool;
 
     // healping methods for avl-tree
     void recursive_clear( base_node* node );
+    static void replace_child( base_node* parent, base_node* old_child, base_node* new_child );
 
     char height( base_node* node );
     void fix_height( base_node* node );
 
+    static size_type subtree_count( const base_node* node ) noexcept
+    {
+        if constexpr (OrderStatistics) return node ? node->count : 0;
+        else return 0;
+    }
+
+    static void fix_count( base_node* node ) noexcept
+    {
+        if constexpr (OrderStatistics) node->count = subtree_count(node->left) + subtree_count(node->right) + 1;
+    }
+
+    // position of node in key order, size() for the sentinel
+    static size_type order_of( const base_node* node ) noexcept;
+
     int balance_factor( base_node* node );
-    void balance_tree( base_node* node );
+    void balance_tree( base_node* node ) { balance_tree(node, &fake_node); }
+    void balance_tree( base_node* node, base_node* top );
     base_node* left_rotate(  iterator it );
     base_node* right_rotate( iterator it );
 
+    // where a key belongs: below parent on the given side, or at equal if the key is present
+    struct insert_position
+    {
+        base_node* parent;
+        bool left;
+        base_node* equal;
+    };
+
+    template< class K >
+    insert_position find_insert_position( const K& key );
+    template< class K >
+    insert_position hint_position( base_node* hint, const K& key );
+
+    template< class... Args >
+    std::pair<iterator, bool> insert_at( const insert_position& pos, Args&&... args )
+    {
+        if (pos.equal != nullptr) return std::make_pair(iterator(pos.equal), false);
+        return std::make_pair(link_node(pos, create_node(pos.parent, std::forward<Args>(args)...)), true);
+    }
+
+    iterator link_node( const insert_position& pos, base_node* node );
+    void rebalance_after_insert( base_node* node );
+
+    // searches, returning the sentinel when there is no such node
+    template< class K >
+    base_node* find_node( const K& key ) const;
+    template< class K >
+    base_node* lower_bound_node( const K& key ) const;
+    template< class K >
+    base_node* upper_bound_node( const K& key ) const;
+
+    // keys are unique, so a hit is the whole range
+    template< class It, class K >
+    std::pair<It, It> equal_range_impl( const K& key ) const
+    {
+        base_node* first = lower_bound_node(key);
+        if (first != &fake_node && !m_comp(key, static_cast<avl_node*>(first)->key)) return std::pair<It, It>(It(first), It(next(first)));
+        return std::pair<It, It>(It(first), It(first));
+    }
+
+    template< class K >
+    std::ranges::subrange<iterator> range_impl( const K& lo, const K& hi ) const
+    {
+        base_node* first = lower_bound_node(lo);
+        base_node* last = first;
+        if (last != &fake_node && m_comp(static_cast<avl_node*>(last)->key, hi)) last = lower_bound_node(hi);
+        return std::ranges::subrange<iterator>(iterator(first), iterator(last));
+    }
+
+    // lower bound of key, which must not be below the key at from
+    template< class K >
+    base_node* lower_bound_from( base_node* from, const K& key ) const;
+
     // for iteration
     static base_node* next( base_node* node );
     static base_node* prev( base_node* node );
+
+    // bulk loading into an empty tree
+    template< std::input_iterator InputIt >
+    void bulk_load( InputIt first, InputIt last );
+    template< class InputIt >
+    void build_from_sorted( InputIt first, size_type count );
+    template< class InputIt >
+    base_node* build_subtree( InputIt& it, size_type count );
+    void attach_root( base_node* root, size_type count ) noexcept;
+
+    // Moves other's whole tree into *this, which must be empty
+    void take_tree( set& other ) noexcept
+    {
+        if (other.fake_node.left == nullptr) return;
+
+        // the pool travels with its nodes; other starts a fresh one if it allocates again
+        m_pool = std::move(other.m_pool);
+        fake_node.left = other.fake_node.left;
+        fake_node.left->parent = &fake_node;
+        m_leftmost = other.m_leftmost;
+        m_rightmost = other.m_rightmost;
+        m_size = other.m_size;
+
+        other.fake_node.left = nullptr;
+        other.m_leftmost = &other.fake_node;
+        other.m_rightmost = &other.fake_node;
+        other.m_size = 0;
+    }
+
+    // Nodes about to move in from other must keep their slabs alive as long as this set's
+    // pool; other's pool is not handed back, so the two never allocate from the same one
+    void share_pool( set& other )
+    {
+        if constexpr (NodePool::enabled)
+        {
+            if (this == &other || !other.m_pool) return;
+            if (!m_pool) m_pool = NodePool::template acquire<pool_type>(m_alloc);
+            m_pool->adopt(*other.m_pool);
+        }
+    }
+
+    // join and split work on detached subtrees whose roots' parent links are ignored
+    base_node* join( base_node* left, base_node* mid, base_node* right );
+    base_node* join( base_node* left, base_node* right );
+    base_node* split( base_node* tree, const Key& key, base_node*& left, base_node*& right );
+
+    // Nodes dropped by the set algebra, chained through right and destroyed once it is done
+    struct graveyard
+    {
+        base_node* head = nullptr;
+        base_node* tail = nullptr;
+        size_type count = 0;
+
+        void bury( base_node* node ) noexcept
+        {
+            node->right = head;
+            head = node;
+            if (tail == nullptr) tail = node;
+            ++count;
+        }
+
+        void bury_tree( base_node* node ) noexcept
+        {
+            if (node == nullptr) return;
+            base_node* right = node->right;
+            bury_tree(node->left);
+            bury_tree(right);
+            bury(node);
+        }
+
+        void append( graveyard& other ) noexcept
+        {
+            if (other.head == nullptr) return;
+            if (tail == nullptr) head = other.head;
+            else tail->right = other.head;
+            tail = other.tail;
+            count += other.count;
+        }
+    };
+
+    // A tree_op that throws has buried every node of both its trees, partial results included
+    using tree_op = base_node* (set::*)( base_node*, base_node*, graveyard&, unsigned );
+
+    base_node* union_trees( base_node* a, base_node* b, graveyard& dead, unsigned threads );
+    base_node* intersect_trees( base_node* a, base_node* b, graveyard& dead, unsigned threads );
+    base_node* subtract_trees( base_node* a, base_node* b, graveyard& dead, unsigned threads );
+
+    // runs op on both pairs, the first on another thread when threads allow
+    void run_both( tree_op op, base_node* a1, base_node* b1, base_node*& out1,
+        base_node* a2, base_node* b2, base_node*& out2, graveyard& dead, unsigned threads );
+    void combine( set& source, tree_op op, unsigned threads );
+    void restore( graveyard& dead );
+
+    // below this many keys in total the set algebra stays on the calling thread
+    static constexpr size_type parallel_threshold = 1ull << 15;
 };
 
-template< class Key >
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics> set_union( set<Key, Compare, Allocator, NodePool, OrderStatistics> lhs,
+    set<Key, Compare, Allocator, NodePool, OrderStatistics> rhs, unsigned threads = 1 )
+{
+    lhs.merge(std::move(rhs), threads);
+    return lhs;
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics> set_intersection( set<Key, Compare, Allocator, NodePool, OrderStatistics> lhs,
+    set<Key, Compare, Allocator, NodePool, OrderStatistics> rhs, unsigned threads = 1 )
+{
+    lhs.intersect(std::move(rhs), threads);
+    return lhs;
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics> set_difference( set<Key, Compare, Allocator, NodePool, OrderStatistics> lhs,
+    set<Key, Compare, Allocator, NodePool, OrderStatistics> rhs, unsigned threads = 1 )
+{
+    lhs.subtract(std::move(rhs), threads);
+    return lhs;
+}
+
+template< class Key, class Compare = std::less<Key>, class Allocator = std::allocator<Key> >
+using order_statistic_set = set<Key, Compare, Allocator, per_container_pool, true>;
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
 template< std::input_iterator InputIt >
-inline set<Key>::set( InputIt first, InputIt last )
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::set( InputIt first, InputIt last, const Compare& comp, const Allocator& alloc )
+    : m_comp(comp), m_alloc(alloc)
 {
-    for (; first != last; ++first) insert(*first);
+    bulk_load(first, last);
 }
 
-template< class Key >
-inline set<Key>::set( std::initializer_list<value_type> init )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::set( std::initializer_list<value_type> init, const Compare& comp, const Allocator& alloc )
+    : m_comp(comp), m_alloc(alloc)
 {
-    for (const auto& k : init) insert(k);
+    bulk_load(init.begin(), init.end());
 }
 
-template< class Key >
-inline set<Key>::set( const set<Key>& other )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::set( const set<Key, Compare, Allocator, NodePool, OrderStatistics>& other )
+    : m_comp(other.m_comp), m_alloc(node_allocator_traits::select_on_container_copy_construction(other.m_alloc))
 {
-    for (auto it = other.begin(); it != other.end; ++it) insert(*it);
+    build_from_sorted(other.begin(), other.size());
 }
 
-template< class Key >
-inline void set<Key>::recursive_clear( base_node* node )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::set( set<Key, Compare, Allocator, NodePool, OrderStatistics>&& other ) noexcept
+    : m_comp(other.m_comp), m_alloc(other.m_alloc)
+{
+    take_tree(other);
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::recursive_clear( base_node* node )
 {
     if ( node != nullptr )
     {
         recursive_clear(node->left);
         recursive_clear(node->right);
-        delete node;
+        destroy_node(node);
     }
 
 }
 
-template< class Key >
-inline char set<Key>::height( base_node* node )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::replace_child( base_node* parent, base_node* old_child, base_node* new_child )
+{
+    if (parent->left == old_child) parent->left = new_child;
+    else parent->right = new_child;
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline char set<Key, Compare, Allocator, NodePool, OrderStatistics>::height( base_node* node )
 {
     return node ? node->height : 0;
 }
 
-template< class Key >
-inline void set<Key>::fix_height( base_node* node )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::fix_height( base_node* node )
 {
     char hl = height(node->left);
     char hr = height(node->right);
     
     node->height = (hl > hr? hl : hr) + 1;
+    fix_count(node);
 }
 
-template< class Key >
-inline int set<Key>::balance_factor( base_node* node )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline int set<Key, Compare, Allocator, NodePool, OrderStatistics>::balance_factor( base_node* node )
 {
     return static_cast<int>(height(node->right)) - static_cast<int>(height(node->left));
 }
 
-template< class Key >
-inline void set<Key>::balance_tree( base_node* node )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::balance_tree( base_node* node, base_node* top )
 {
-    while (node != &fake_node)
+    while (node != top)
     {   
         int left_height = height(node->left);
         int right_height = height(node->right);
@@ -212,6 +584,7 @@ inline void set<Key>::balance_tree( base_node* node )
         int balance = left_height - right_height;
 
         if (p_height != node->height) node->height = p_height;
+        fix_count(node);
         if (balance == 2)
         {
             if (height(node->left->left) >= height(node->left->right)) right_rotate(node);
@@ -236,8 +609,8 @@ inline void set<Key>::balance_tree( base_node* node )
     }
 }
 
-template< class Key >
-inline set<Key>::base_node* set<Key>::left_rotate( set<Key>::iterator it )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::left_rotate( set<Key, Compare, Allocator, NodePool, OrderStatistics>::iterator it )
 {
     base_node* node = it.m_node;
     base_node* right_node = node->right;
@@ -260,8 +633,8 @@ inline set<Key>::base_node* set<Key>::left_rotate( set<Key>::iterator it )
     return right_node;
 }
 
-template< class Key >
-inline set<Key>::base_node* set<Key>::right_rotate( set<Key>::iterator it )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::right_rotate( set<Key, Compare, Allocator, NodePool, OrderStatistics>::iterator it )
 {
     base_node* node = it.m_node;
     base_node* left_node = node->left;
@@ -284,8 +657,8 @@ inline set<Key>::base_node* set<Key>::right_rotate( set<Key>::iterator it )
     return left_node;
 }
 
-template< class Key >
-inline set<Key>::base_node* set<Key>::next( base_node* node )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::next( base_node* node )
 {
     if (node->right != nullptr) 
     {
@@ -307,8 +680,8 @@ inline set<Key>::base_node* set<Key>::next( base_node* node )
     }
 }
 
-template< class Key >
-inline set<Key>::base_node* set<Key>::prev( base_node* node )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::prev( base_node* node )
 {
     if (node->left != nullptr)
     {
@@ -330,224 +703,964 @@ inline set<Key>::base_node* set<Key>::prev( base_node* node )
     }
 }
 
-template< class Key >
-inline set<Key>::iterator set<Key>::begin()
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::iterator set<Key, Compare, Allocator, NodePool, OrderStatistics>::begin()
 {
-    if (fake_node.left == nullptr) return end();
-    
-    base_node* node = fake_node.left;
-    while (node->left != nullptr) node = node->left;
-    return iterator(node);
+    return iterator(m_leftmost);
 }
 
-template< class Key >
-inline set<Key>::const_iterator set<Key>::begin() const
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::const_iterator set<Key, Compare, Allocator, NodePool, OrderStatistics>::begin() const
 {
-    if (fake_node.left == nullptr) return end();
-    
-    base_node* node = fake_node.left;
-    while (node->left != nullptr) node = node->left;
-    return const_iterator(node);
+    return const_iterator(m_leftmost);
 }
 
-template< class Key >
-inline set<Key>::const_iterator set<Key>::cbegin() const noexcept
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::const_iterator set<Key, Compare, Allocator, NodePool, OrderStatistics>::cbegin() const noexcept
 {
-    if (fake_node.left == nullptr) return cend();
-    
-    base_node* node = fake_node.left;
-    while (node->left != nullptr) node = node->left;
-    return const_iterator(node);
+    return const_iterator(m_leftmost);
 }
 
-
-template< class Key >
-inline set<Key>::iterator set<Key>::end()
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::iterator set<Key, Compare, Allocator, NodePool, OrderStatistics>::end()
 {
-    if (fake_node.left == nullptr) return iterator(nullptr);
-    
-    base_node* node = fake_node.left;
-    while (node->right != nullptr) node = node->right;
-    return iterator(next(node));
+    return iterator(&fake_node);
 }
 
-template< class Key >
-inline set<Key>::const_iterator set<Key>::end() const
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::const_iterator set<Key, Compare, Allocator, NodePool, OrderStatistics>::end() const
 {
-    if (fake_node.left == nullptr) return iterator(nullptr);
-    
-    base_node* node = fake_node.left;
-    while (node->right != nullptr) node = node->right;
-    return const_iterator(next(node));
+    return const_iterator(const_cast<base_node*>(&fake_node));
 }
 
-template< class Key >
-inline set<Key>::const_iterator set<Key>::cend() const noexcept
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::const_iterator set<Key, Compare, Allocator, NodePool, OrderStatistics>::cend() const noexcept
 {
-    if (fake_node.left == nullptr) return iterator(nullptr);
-    
-    base_node* node = fake_node.left;
-    while (node->right != nullptr) node = node->right;
-    return const_iterator(next(node));
+    return const_iterator(const_cast<base_node*>(&fake_node));
 }
 
-template< class Key >
-inline void set<Key>::clear()
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::clear()
 {
     recursive_clear(fake_node.left);
     fake_node.left = nullptr;
+    m_leftmost = &fake_node;
+    m_rightmost = &fake_node;
     m_size = 0;
 }
 
-template< class Key >
-inline std::pair<typename set<Key>::iterator, bool> set<Key>::insert( const set<Key>::value_type& key )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< class... Args >
+inline std::pair<typename set<Key, Compare, Allocator, NodePool, OrderStatistics>::iterator, bool> set<Key, Compare, Allocator, NodePool, OrderStatistics>::emplace( Args&&... args )
 {
-    if (fake_node.left == nullptr)
+    avl_node* node = create_node(nullptr, std::forward<Args>(args)...);
+    insert_position pos;
+    try
+    {
+        pos = find_insert_position(node->key);
+    }
+    catch (...)
     {
-        fake_node.left = new avl_node(key, &fake_node);
-        ++m_size;
-        return std::make_pair(iterator(fake_node.left), true);
+        destroy_node(node);
+        throw;
     }
 
+    if (pos.equal != nullptr)
+    {
+        destroy_node(node);
+        return std::make_pair(iterator(pos.equal), false);
+    }
+    return std::make_pair(link_node(pos, node), true);
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< class... Args >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::iterator set<Key, Compare, Allocator, NodePool, OrderStatistics>::emplace_hint( const_iterator hint, Args&&... args )
+{
+    avl_node* node = create_node(nullptr, std::forward<Args>(args)...);
+    insert_position pos;
+    try
+    {
+        pos = hint_position(hint.m_node, node->key);
+    }
+    catch (...)
+    {
+        destroy_node(node);
+        throw;
+    }
+
+    if (pos.equal != nullptr)
+    {
+        destroy_node(node);
+        return iterator(pos.equal);
+    }
+    return link_node(pos, node);
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< class K >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::insert_position set<Key, Compare, Allocator, NodePool, OrderStatistics>::find_insert_position( const K& key )
+{
+    base_node* parent = &fake_node;
     base_node* node = fake_node.left;
-    while (true)
+    bool left = true;
+    while (node != nullptr)
     {
-        if (key < static_cast<avl_node*>(node)->key)
+        parent = node;
+        if (m_comp(key, static_cast<avl_node*>(node)->key))
         {
-            if (node->left == nullptr)
-            {
-                node->left = new avl_node(key, node);
-                ++m_size;
-                balance_tree(node);
-                return std::make_pair(iterator(node->left), true);
-            }
+            left = true;
             node = node->left;
         }
-
-        else if (static_cast<avl_node*>(node)->key < key)
+        else if (m_comp(static_cast<avl_node*>(node)->key, key))
         {
-            if (node->right == nullptr)
-            {
-                node->right = new avl_node(key, node);
-                ++m_size;
-                balance_tree(node);
-                return std::make_pair(iterator(node->right), true);
-            }
+            left = false;
             node = node->right;
         }
-        else return std::make_pair(iterator(node), false);
+        else return insert_position{ node, false, node };
+    }
+    return insert_position{ parent, left, nullptr };
+}
+
+// Checks key against hint and its in-order neighbour. Between them one of the two has a free
+// child slot next to the other: hint's left when its predecessor is above it, else the
+// predecessor's right. A wrong hint falls back to the search from the root.
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< class K >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::insert_position set<Key, Compare, Allocator, NodePool, OrderStatistics>::hint_position( base_node* hint, const K& key )
+{
+    if (hint == &fake_node)
+    {
+        if (m_size != 0 && m_comp(static_cast<avl_node*>(m_rightmost)->key, key)) return insert_position{ m_rightmost, false, nullptr };
+        return find_insert_position(key);
+    }
+
+    if (m_comp(key, static_cast<avl_node*>(hint)->key))
+    {
+        if (hint == m_leftmost) return insert_position{ hint, true, nullptr };
+
+        base_node* before = prev(hint);
+        if (!m_comp(static_cast<avl_node*>(before)->key, key)) return find_insert_position(key);
+        if (before->right == nullptr) return insert_position{ before, false, nullptr };
+        return insert_position{ hint, true, nullptr };
+    }
+
+    if (m_comp(static_cast<avl_node*>(hint)->key, key))
+    {
+        if (hint == m_rightmost) return insert_position{ hint, false, nullptr };
+
+        base_node* after = next(hint);
+        if (!m_comp(key, static_cast<avl_node*>(after)->key)) return find_insert_position(key);
+        if (hint->right == nullptr) return insert_position{ hint, false, nullptr };
+        return insert_position{ after, true, nullptr };
+    }
+
+    return insert_position{ hint, false, hint };
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::iterator set<Key, Compare, Allocator, NodePool, OrderStatistics>::link_node( const insert_position& pos, base_node* node )
+{
+    node->parent = pos.parent;
+    fix_height(node);
+    if (pos.left) pos.parent->left = node;
+    else pos.parent->right = node;
+
+    if (m_size == 0) m_leftmost = m_rightmost = node;
+    else if (pos.left && pos.parent == m_leftmost) m_leftmost = node;
+    else if (!pos.left && pos.parent == m_rightmost) m_rightmost = node;
+    ++m_size;
+
+    rebalance_after_insert(pos.parent);
+    return iterator(node);
+}
+
+// A new leaf lengthens at most the path above it, and once a subtree on that path is back at its
+// old height (after a rotation, or because the other side was taller) nothing above changes.
+// Subtree counts do change all the way up, so with order statistics the whole path is fixed.
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::rebalance_after_insert( base_node* node )
+{
+    if constexpr (OrderStatistics) balance_tree(node);
+    else
+    {
+        while (node != &fake_node)
+        {
+            base_node* parent = node->parent;
+            const bool is_left = parent->left == node;
+            const char old_height = node->height;
+
+            balance_tree(node, parent);
+            if ((is_left ? parent->left : parent->right)->height == old_height) return;
+            node = parent;
+        }
     }
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::iterator set<Key, Compare, Allocator, NodePool, OrderStatistics>::erase(const_iterator pos)
+{
+    base_node* node = pos.m_node;
+    if (node == &fake_node) return end();
 
+    base_node* successor = next(node);
+    if (node == m_leftmost) m_leftmost = successor;
+    if (node == m_rightmost) m_rightmost = (m_size == 1) ? &fake_node : prev(node);
+
+    base_node* p_balance = nullptr;
+    if (node->left != nullptr && node->right != nullptr)
+    {
+        // the in-order successor has no left child; it takes node's place in the tree
+        base_node* s_parent = successor->parent;
+        if (s_parent == node) p_balance = successor;
+        else
+        {
+            p_balance = s_parent;
+            s_parent->left = successor->right;
+            if (successor->right != nullptr) successor->right->parent = s_parent;
+
+            successor->right = node->right;
+            node->right->parent = successor;
+        }
+
+        successor->left = node->left;
+        node->left->parent = successor;
+        successor->parent = node->parent;
+        successor->height = node->height;
+        replace_child(node->parent, node, successor);
+    }
+
+    else
+    {
+        base_node* child = (node->left != nullptr) ? node->left : node->right;
+        if (child != nullptr) child->parent = node->parent;
+        replace_child(node->parent, node, child);
+        p_balance = node->parent;
+    }
+
+    destroy_node(node);
+    --m_size;
+
+    balance_tree(p_balance);
+
+    return iterator(successor);
 }
 
-template< class Key >
-inline std::pair<typename set<Key>::iterator, bool> set<Key>::insert( set<Key>::value_type&& key )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< class K >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::find_node( const K& key ) const
 {
-    if (fake_node.left == nullptr)
+    base_node* node = fake_node.left;
+    while (node != nullptr)
     {
-        fake_node.left = new avl_node(std::move(key), &fake_node);
-        ++m_size;
-        return std::make_pair(iterator(fake_node.left), true);
+        if (m_comp(key, static_cast<avl_node*>(node)->key)) node = node->left;
+        else if (m_comp(static_cast<avl_node*>(node)->key, key)) node = node->right;
+        else return node;
     }
+    return const_cast<base_node*>(&fake_node);
+}
 
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< class K >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::lower_bound_node( const K& key ) const
+{
+    base_node* result = const_cast<base_node*>(&fake_node);
     base_node* node = fake_node.left;
-    while (true)
+    while (node != nullptr)
     {
-        if (key < static_cast<avl_node*>(node)->key)
+        if (m_comp(static_cast<avl_node*>(node)->key, key)) node = node->right;
+        else
         {
-            if (node->left == nullptr)
-            {
-                node->left = new avl_node(std::move(key), node);
-                ++m_size;
-                balance_tree(node);
-                return std::make_pair(iterator(node->left), true);
-            }
+            result = node;
+            node = node->left;
+        }
+    }
+    return result;
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< class K >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::upper_bound_node( const K& key ) const
+{
+    base_node* result = const_cast<base_node*>(&fake_node);
+    base_node* node = fake_node.left;
+    while (node != nullptr)
+    {
+        if (m_comp(key, static_cast<avl_node*>(node)->key))
+        {
+            result = node;
             node = node->left;
         }
+        else node = node->right;
+    }
+    return result;
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>& set<Key, Compare, Allocator, NodePool, OrderStatistics>::operator=( const set& other )
+{
+    if (this == &other) return *this;
+
+    clear();
+    m_comp = other.m_comp;
+    if constexpr (node_allocator_traits::propagate_on_container_copy_assignment::value)
+        m_alloc = other.m_alloc;
+
+    build_from_sorted(other.begin(), other.size());
+    return *this;
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>& set<Key, Compare, Allocator, NodePool, OrderStatistics>::operator=( set&& other )
+    noexcept(node_allocator_traits::propagate_on_container_move_assignment::value || node_allocator_traits::is_always_equal::value)
+{
+    if (this == &other) return *this;
+
+    clear();
+    m_comp = other.m_comp;
+    if constexpr (node_allocator_traits::propagate_on_container_move_assignment::value)
+    {
+        m_alloc = std::move(other.m_alloc);
+        take_tree(other);
+    }
+    else if (m_alloc == other.m_alloc) take_tree(other);
+    else
+    {
+        build_from_sorted(std::make_move_iterator(other.begin()), other.size());
+        other.clear();
+    }
+
+    return *this;
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>& set<Key, Compare, Allocator, NodePool, OrderStatistics>::operator=( std::initializer_list<value_type> ilist )
+{
+    clear();
+    bulk_load(ilist.begin(), ilist.end());
+    return *this;
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< std::input_iterator InputIt >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::bulk_load( InputIt first, InputIt last )
+{
+    auto not_before = [this](const Key& lhs, const Key& rhs) { return !m_comp(lhs, rhs); };
+
+    if constexpr (std::forward_iterator<InputIt>)
+    {
+        // strictly increasing input is built straight from the range
+        if (std::adjacent_find(first, last, not_before) == last)
+        {
+            build_from_sorted(first, static_cast<size_type>(std::distance(first, last)));
+            return;
+        }
+    }
+
+    // otherwise sort a copy, keeping the first of equivalent keys as repeated insert would
+    std::vector<Key> buffer(first, last);
+    std::stable_sort(buffer.begin(), buffer.end(), m_comp);
+    buffer.erase(std::unique(buffer.begin(), buffer.end(), not_before), buffer.end());
+
+    build_from_sorted(std::make_move_iterator(buffer.begin()), buffer.size());
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< class InputIt >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::build_from_sorted( InputIt first, size_type count )
+{
+    attach_root(build_subtree(first, count), count);
+}
+
+// Makes root, which may be null, the tree of this set
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::attach_root( base_node* root, size_type count ) noexcept
+{
+    fake_node.left = root;
+    m_leftmost = &fake_node;
+    m_rightmost = &fake_node;
+    m_size = count;
+    if (root == nullptr) return;
+
+    root->parent = &fake_node;
+
+    m_leftmost = root;
+    while (m_leftmost->left != nullptr) m_leftmost = m_leftmost->left;
+    m_rightmost = root;
+    while (m_rightmost->right != nullptr) m_rightmost = m_rightmost->right;
+}
 
-        else if (static_cast<avl_node*>(node)->key < key)
+// Builds a perfectly balanced subtree from the next count keys. Nodes are created in key order,
+// so a pooled set lays them out contiguously. On an exception everything built so far is freed.
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< class InputIt >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::build_subtree( InputIt& it, size_type count )
+{
+    if (count == 0) return nullptr;
+
+    const size_type left_count = count / 2;
+    base_node* left = build_subtree(it, left_count);
+
+    base_node* node = nullptr;
+    try
+    {
+        node = create_node(nullptr, *it);
+    }
+    catch (...)
+    {
+        recursive_clear(left);
+        throw;
+    }
+    ++it;
+
+    node->left = left;
+    if (left != nullptr) left->parent = node;
+
+    try
+    {
+        node->right = build_subtree(it, count - left_count - 1);
+    }
+    catch (...)
+    {
+        recursive_clear(node);
+        throw;
+    }
+    if (node->right != nullptr) node->right->parent = node;
+
+    fix_height(node);
+    return node;
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::join( base_node* left, base_node* mid, base_node* right )
+{
+    const int left_height = height(left);
+    const int right_height = height(right);
+
+    if (left_height <= right_height + 1 && right_height <= left_height + 1)
+    {
+        mid->left = left;
+        mid->right = right;
+        if (left != nullptr) left->parent = mid;
+        if (right != nullptr) right->parent = mid;
+        fix_height(mid);
+        return mid;
+    }
+
+    // hang mid off the spine of the taller tree where the heights meet, then rebalance upwards
+    base_node anchor;
+    base_node* parent = nullptr;
+    base_node* spine = nullptr;
+
+    if (left_height > right_height)
+    {
+        anchor.left = left;
+        left->parent = &anchor;
+
+        parent = left;
+        spine = left->right;
+        while (height(spine) > right_height + 1)
         {
-            if (node->right == nullptr)
+            parent = spine;
+            spine = spine->right;
+        }
+
+        mid->left = spine;
+        mid->right = right;
+        if (right != nullptr) right->parent = mid;
+        parent->right = mid;
+    }
+
+    else 
+    {
+        anchor.left = right;
+        right->parent = &anchor;
+
+        parent = right;
+        spine = right->left;
+        while (height(spine) > left_height + 1)
+        {
+            parent = spine;
+            spine = spine->left;
+        }
+
+        mid->right = spine;
+        mid->left = left;
+        if (left != nullptr) left->parent = mid;
+        parent->left = mid;
+    }
+
+    if (spine != nullptr) spine->parent = mid;
+    mid->parent = parent;
+    fix_height(mid);
+    balance_tree(parent, &anchor);
+
+    anchor.left->parent = nullptr;
+    return anchor.left;
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::join( base_node* left, base_node* right )
+{
+    if (right == nullptr) return left;
+    if (left == nullptr) return right;
+
+    // the minimum of right becomes the middle key
+    base_node anchor;
+    anchor.left = right;
+    right->parent = &anchor;
+
+    base_node* min = right;
+    while (min->left != nullptr) min = min->left;
+
+    base_node* parent = min->parent;
+    replace_child(parent, min, min->right);
+    if (min->right != nullptr) min->right->parent = parent;
+    balance_tree(parent, &anchor);
+
+    return join(left, min, anchor.left);
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::split( base_node* tree, const Key& key, base_node*& left, base_node*& right )
+{
+    if (tree == nullptr)
+    {
+        left = right = nullptr;
+        return nullptr;
+    }
+
+    base_node* tree_left = tree->left;
+    base_node* tree_right = tree->right;
+    const Key& tree_key = static_cast<avl_node*>(tree)->key;
+
+    if (m_comp(key, tree_key))
+    {
+        base_node* found = split(tree_left, key, left, right);
+        right = join(right, tree, tree_right);
+        return found;
+    }
+
+    if (m_comp(tree_key, key))
+    {
+        base_node* found = split(tree_right, key, left, right);
+        left = join(tree_left, tree, left);
+        return found;
+    }
+
+    left = tree_left;
+    right = tree_right;
+    return tree;
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::union_trees( base_node* a, base_node* b, graveyard& dead, unsigned threads )
+{
+    if (a == nullptr) return b;
+    if (b == nullptr) return a;
+
+    // split only compares on its way down, so a throw leaves both trees as they were
+    base_node* b_left = nullptr;
+    base_node* b_right = nullptr;
+    base_node* duplicate = nullptr;
+    try
+    {
+        duplicate = split(b, static_cast<avl_node*>(a)->key, b_left, b_right);
+    }
+    catch (...)
+    {
+        dead.bury_tree(a);
+        dead.bury_tree(b);
+        throw;
+    }
+    if (duplicate != nullptr) dead.bury(duplicate);
+
+    base_node* left = nullptr;
+    base_node* right = nullptr;
+    try
+    {
+        run_both(&set::union_trees, a->left, b_left, left, a->right, b_right, right, dead, threads);
+    }
+    catch (...)
+    {
+        dead.bury(a);
+        throw;
+    }
+
+    return join(left, a, right);
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::intersect_trees( base_node* a, base_node* b, graveyard& dead, unsigned threads )
+{
+    if (a == nullptr || b == nullptr)
+    {
+        dead.bury_tree(a);
+        dead.bury_tree(b);
+        return nullptr;
+    }
+
+    base_node* b_left = nullptr;
+    base_node* b_right = nullptr;
+    base_node* duplicate = nullptr;
+    try
+    {
+        duplicate = split(b, static_cast<avl_node*>(a)->key, b_left, b_right);
+    }
+    catch (...)
+    {
+        dead.bury_tree(a);
+        dead.bury_tree(b);
+        throw;
+    }
+
+    base_node* left = nullptr;
+    base_node* right = nullptr;
+    try
+    {
+        run_both(&set::intersect_trees, a->left, b_left, left, a->right, b_right, right, dead, threads);
+    }
+    catch (...)
+    {
+        dead.bury(a);
+        if (duplicate != nullptr) dead.bury(duplicate);
+        throw;
+    }
+
+    if (duplicate != nullptr)
+    {
+        dead.bury(duplicate);
+        return join(left, a, right);
+    }
+
+    dead.bury(a);
+    return join(left, right);
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::subtract_trees( base_node* a, base_node* b, graveyard& dead, unsigned threads )
+{
+    if (a == nullptr)
+    {
+        dead.bury_tree(b);
+        return nullptr;
+    }
+    if (b == nullptr) return a;
+
+    base_node* a_left = nullptr;
+    base_node* a_right = nullptr;
+    base_node* duplicate = nullptr;
+    try
+    {
+        duplicate = split(a, static_cast<avl_node*>(b)->key, a_left, a_right);
+    }
+    catch (...)
+    {
+        dead.bury_tree(a);
+        dead.bury_tree(b);
+        throw;
+    }
+    if (duplicate != nullptr) dead.bury(duplicate);
+
+    base_node* left = nullptr;
+    base_node* right = nullptr;
+    try
+    {
+        run_both(&set::subtract_trees, a_left, b->left, left, a_right, b->right, right, dead, threads);
+    }
+    catch (...)
+    {
+        dead.bury(b);
+        throw;
+    }
+
+    dead.bury(b);
+    return join(left, right);
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::run_both( tree_op op, base_node* a1, base_node* b1, base_node*& out1,
+    base_node* a2, base_node* b2, base_node*& out2, graveyard& dead, unsigned threads )
+{
+    if (threads > 1)
+    {
+        graveyard first_dead;
+        std::future<void> first;
+        try
+        {
+            first = std::async(std::launch::async, [&, this] { out1 = (this->*op)(a1, b1, first_dead, threads / 2); });
+        }
+        catch (const std::system_error&) {} // no thread to spare, do both here
+
+        if (first.valid())
+        {
+            try
             {
-                node->right = new avl_node(std::move(key), node);
-                ++m_size;
-                balance_tree(node);
-                return std::make_pair(iterator(node->right), true);
+                out2 = (this->*op)(a2, b2, dead, threads - threads / 2);
             }
-            node = node->right;
+            catch (...)
+            {
+                // the other half still uses the comparator and its own graveyard
+                try
+                {
+                    first.get();
+                    dead.bury_tree(out1);
+                }
+                catch (...) {}
+                dead.append(first_dead);
+                throw;
+            }
+
+            try
+            {
+                first.get();
+            }
+            catch (...)
+            {
+                dead.append(first_dead);
+                dead.bury_tree(out2);
+                throw;
+            }
+            dead.append(first_dead);
+            return;
         }
-        else return std::make_pair(iterator(node), false);
     }
 
+    try
+    {
+        out1 = (this->*op)(a1, b1, dead, 1);
+    }
+    catch (...)
+    {
+        dead.bury_tree(a2);
+        dead.bury_tree(b2);
+        throw;
+    }
+
+    try
+    {
+        out2 = (this->*op)(a2, b2, dead, 1);
+    }
+    catch (...)
+    {
+        dead.bury_tree(out1);
+        throw;
+    }
 }
 
-template< class Key >
-inline set<Key>::iterator set<Key>::erase(const_iterator pos)
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::combine( set& source, tree_op op, unsigned threads )
 {
-    avl_node* node = static_cast<avl_node*>(pos.m_node);
-    if (node == nullptr) return end();
+    share_pool(source);
 
-    base_node* to_delete = nullptr;
-    if (node->left == nullptr || node->right == nullptr) to_delete = node;
+    const size_type total = m_size + source.m_size;
+    if (total < parallel_threshold) threads = 1;
 
-    else 
+    base_node* a = fake_node.left;
+    base_node* b = source.fake_node.left;
+    source.attach_root(nullptr, 0);
+
+    graveyard dead;
+    base_node* root = nullptr;
+    try
     {
-        to_delete = next(node);
-        node->key = static_cast<avl_node*>(to_delete)->key;
+        root = (this->*op)(a, b, dead, threads);
+    }
+    catch (...)
+    {
+        attach_root(nullptr, 0);
+        restore(dead);
+        throw;
     }
 
-    base_node* child = (to_delete->left != nullptr) ? to_delete->left : to_delete->right;
+    attach_root(root, total);
+    m_size -= dead.count;
 
-    if (child != nullptr) child->parent = to_delete->parent;
-    if(to_delete->parent == nullptr) fake_node.left = child;
-    else if (to_delete == to_delete->parent->left) to_delete->parent->left = child;
-    else to_delete->parent->right = child;
+    while (dead.head != nullptr)
+    {
+        base_node* next = dead.head->right;
+        destroy_node(dead.head);
+        dead.head = next;
+    }
+}
 
-    base_node* p_balance = to_delete->parent;
-    delete to_delete;
-    --m_size;
+// Inserts the nodes of an abandoned set operation into this set, which is empty. Duplicates are
+// destroyed, and so is every node still left once comp throws again.
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::restore( graveyard& dead )
+{
+    base_node* node = dead.head;
+    try
+    {
+        while (node != nullptr)
+        {
+            base_node* next = node->right;
+            const insert_position pos = find_insert_position(static_cast<avl_node*>(node)->key);
+            if (pos.equal != nullptr) destroy_node(node);
+            else
+            {
+                node->left = nullptr;
+                node->right = nullptr;
+                link_node(pos, node);
+            }
+            node = next;
+        }
+    }
+    catch (...)
+    {
+        while (node != nullptr)
+        {
+            base_node* next = node->right;
+            destroy_node(node);
+            node = next;
+        }
+    }
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::merge( set&& source, unsigned threads )
+{
+    if (this == &source) return;
+    if (m_alloc == source.m_alloc) return combine(source, &set::union_trees, threads);
 
-    if (p_balance != nullptr) balance_tree(p_balance);
+    // nodes owned by another allocator cannot change hands, move the keys instead
+    for (auto it = source.begin(); it != source.end(); ++it) insert(std::move(*it));
+    source.clear();
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::intersect( set&& source, unsigned threads )
+{
+    if (this == &source) return;
+    if (m_alloc == source.m_alloc) return combine(source, &set::intersect_trees, threads);
 
-    return iterator(p_balance);
+    for (auto it = begin(); it != end();)
+    {
+        if (source.find(*it) == source.end()) it = erase(it);
+        else ++it;
+    }
+    source.clear();
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline void set<Key, Compare, Allocator, NodePool, OrderStatistics>::subtract( set&& source, unsigned threads )
+{
+    if (this == &source) return clear();
+    if (m_alloc == source.m_alloc) return combine(source, &set::subtract_trees, threads);
+
+    for (auto it = source.begin(); it != source.end(); ++it)
+    {
+        auto found = find(*it);
+        if (found != end()) erase(found);
+    }
+    source.clear();
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::size_type set<Key, Compare, Allocator, NodePool, OrderStatistics>::order_of( const base_node* node ) noexcept
+{
+    // only the sentinel has no parent, and its left child is the root
+    if (node->parent == nullptr) return subtree_count(node->left);
+
+    size_type order = subtree_count(node->left);
+    for (; node->parent->parent != nullptr; node = node->parent)
+    {
+        if (node == node->parent->right) order += subtree_count(node->parent->left) + 1;
+    }
+    return order;
 }
 
-template< class Key >
-inline set<Key>::iterator set<Key>::find(const Key& key) 
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::iterator set<Key, Compare, Allocator, NodePool, OrderStatistics>::find_by_order( size_type order ) requires OrderStatistics
 {
+    if (order >= m_size) return end();
+
     base_node* node = fake_node.left;
-    while (node != nullptr)
+    while (true)
     {
-        if (key < static_cast<avl_node*>(node)->key) node = node->left;
-        else if (key > static_cast<avl_node*>(node)->key) node = node->right;
-        else return iterator(node);
+        size_type left_count = subtree_count(node->left);
+        if (order < left_count) node = node->left;
+        else if (order == left_count) return iterator(node);
+        else
+        {
+            order -= left_count + 1;
+            node = node->right;
+        }
     }
-    return end();
 }
 
-template< class Key >
-inline set<Key>::const_iterator set<Key>::find(const Key& key) const 
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::const_iterator set<Key, Compare, Allocator, NodePool, OrderStatistics>::find_by_order( size_type order ) const requires OrderStatistics
 {
+    return const_cast<set*>(this)->find_by_order(order);
+}
+
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::size_type set<Key, Compare, Allocator, NodePool, OrderStatistics>::order_of_key( const value_type& key ) const requires OrderStatistics
+{
+    size_type order = 0;
     base_node* node = fake_node.left;
     while (node != nullptr)
     {
-        if (key < static_cast<avl_node*>(node)->key) node = node->left;
-        else if (key > static_cast<avl_node*>(node)->key) node = node->right;
-        else return const_iterator(node);
+        if (m_comp(static_cast<avl_node*>(node)->key, key))
+        {
+            order += subtree_count(node->left) + 1;
+            node = node->right;
+        }
+        else node = node->left;
     }
-    return cend();
+    return order;
 }
 
-template< class Key >
-inline set<Key>& set<Key>::operator=( const set& other )
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< std::ranges::input_range R >
+inline std::vector<typename set<Key, Compare, Allocator, NodePool, OrderStatistics>::iterator> set<Key, Compare, Allocator, NodePool, OrderStatistics>::find_many( R&& sorted_keys ) const
+    requires std::convertible_to<std::ranges::range_reference_t<R>, const value_type&> || transparent_compare
 {
-    for (auto it = other.begin(); it != other.end(); ++it) insert(*it);
+    std::vector<iterator> result;
+    if constexpr (std::ranges::sized_range<R>) result.reserve(std::ranges::size(sorted_keys));
+
+    base_node* const end_node = const_cast<base_node*>(&fake_node);
+    base_node* node = m_leftmost;
+    for (auto&& key : sorted_keys)
+    {
+        if (node != end_node) node = lower_bound_from(node, key);
+        if (node != end_node && !m_comp(key, static_cast<avl_node*>(node)->key)) result.push_back(iterator(node));
+        else result.push_back(iterator(end_node));
+    }
+    return result;
 }
 
-template< class Key >
-inline set<Key>& set<Key>::operator=( std::initializer_list<value_type> ilist )
+// Climbs from from until the subtree reached is bounded on the right by an ancestor not below
+// key, then descends in it as lower_bound does. The climb and the descent are both about
+// log of the distance between from and the result.
+template< class Key, class Compare, class Allocator, class NodePool, bool OrderStatistics >
+template< class K >
+inline set<Key, Compare, Allocator, NodePool, OrderStatistics>::base_node* set<Key, Compare, Allocator, NodePool, OrderStatistics>::lower_bound_from( base_node* from, const K& key ) const
 {
-    for (const auto& it : ilist) insert(it); 
+    base_node* result = const_cast<base_node*>(&fake_node);
+    base_node* node = from;
+    while (node->parent != &fake_node)
+    {
+        base_node* parent = node->parent;
+        if (parent->left == node && !m_comp(static_cast<avl_node*>(parent)->key, key))
+        {
+            result = parent;
+            break;
+        }
+        node = parent;
+    }
+
+    while (node != nullptr)
+    {
+        if (m_comp(static_cast<avl_node*>(node)->key, key)) node = node->right;
+        else
+        {
+            result = node;
+            node = node->left;
+        }
+    }
+    return result;
 }
 
 
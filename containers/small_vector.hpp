@@ -0,0 +1,693 @@
+#ifndef OWN_SMALL_VECTOR_H
+#define OWN_SMALL_VECTOR_H
+
+// CXX20
+
+#include "vector.hpp"
+
+// vector with room for N elements inside the object itself. The heap is only touched
+// once the size exceeds N; iterators and the relocation helpers are shared with vector.
+template <
+    class T, std::size_t N, class Allocator = std::allocator<T>, class GrowthPolicy = growth_2x>
+class small_vector
+{
+private:
+    using base_vector = vector<T, Allocator, GrowthPolicy>;
+
+public:
+    // Type declaration
+    using value_type               =    T;
+    using allocator_type           =    Allocator;
+    using growth_policy            =    GrowthPolicy;
+    using size_type                =    std::size_t;
+    using difference_type          =    std::ptrdiff_t;
+    using reference                =    value_type&;
+    using const_reference          =    const value_type&;
+    using pointer                  =    typename std::allocator_traits<Allocator>::pointer;
+    using const_pointer            =    typename std::allocator_traits<Allocator>::const_pointer;
+    using iterator                 =    typename base_vector::iterator;
+    using const_iterator           =    typename base_vector::const_iterator;
+    using reverse_iterator         =    std::reverse_iterator<iterator>;
+    using const_reverse_iterator   =    std::reverse_iterator<const_iterator>;
+
+    static_assert(N > 0, "small_vector needs room for at least one inline element");
+    static_assert(std::is_same_v<pointer, T*>, "small_vector requires an allocator with raw pointers");
+
+    static constexpr size_type inline_capacity = N;
+
+    // Constructors and Destructor
+    small_vector() noexcept(noexcept(Allocator()));
+    explicit small_vector(const Allocator& alloc) noexcept;
+    small_vector(size_type count,
+                 const T& value,
+                 const Allocator& alloc = Allocator());
+    explicit small_vector(size_type count,
+                          const Allocator& alloc = Allocator());
+    template <std::input_iterator InputIt>
+    small_vector(InputIt first, InputIt last,
+                 const Allocator& alloc = Allocator());
+    small_vector(const small_vector& other);
+    small_vector(const small_vector& other, const Allocator& alloc);
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+    small_vector(small_vector&& other, const Allocator& alloc);
+    small_vector(std::initializer_list<T> init,
+                 const Allocator& alloc = Allocator());
+    ~small_vector();
+
+    // Operator =
+    small_vector& operator=( const small_vector& other );
+    small_vector& operator=( small_vector&& other );
+    small_vector& operator=( std::initializer_list<value_type> ilist );
+
+    // Assign methods
+    void assign(size_type count, const T& value);
+    template <std::input_iterator InputIt>
+    void assign(InputIt first, InputIt last);
+    void assign(std::initializer_list<T> ilist);
+    template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+    void assign_range(R&& rg);
+
+    // Get allocator
+    allocator_type get_allocator() const { return m_alloc; }
+
+    // Element access
+    reference at( size_type pos );
+    const_reference at( size_type pos ) const;
+
+    reference operator[]( size_type pos ) { return *(m_arr + pos); }
+    const_reference operator[]( size_type pos ) const { return *(m_arr + pos); }
+
+    reference front() { return *m_arr; }
+    const_reference front() const { return *m_arr; }
+
+    reference back() { return *(m_arr + m_size - 1ul); }
+    const_reference back() const { return *(m_arr + m_size - 1ul); }
+
+    T* data() noexcept { return m_arr; }
+    const T* data() const noexcept { return m_arr; }
+
+    // Iterators
+    iterator begin() noexcept { return iterator(m_arr); }
+    const_iterator begin() const noexcept { return const_iterator(m_arr); }
+    const_iterator cbegin() const noexcept { return const_iterator(m_arr); }
+
+    iterator end() noexcept { return iterator(m_arr + m_size); }
+    const_iterator end() const noexcept { return const_iterator(m_arr + m_size); }
+    const_iterator cend() const noexcept { return const_iterator(m_arr + m_size); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(cend()); }
+
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+    const_reverse_iterator crend() const noexcept { return const_reverse_iterator(cbegin()); }
+
+    // Capacity
+    bool empty() const noexcept { return m_size == 0ul; }
+    size_type size() const noexcept { return m_size; }
+    size_type max_size() const noexcept { return std::numeric_limits<difference_type>::max(); }
+    void reserve( size_type new_cap );
+    size_type capacity() const noexcept { return m_capacity; }
+    void shrink_to_fit();
+    bool is_small() const noexcept { return m_arr == inline_data(); }
+
+    // Modifiers
+    void clear() noexcept;
+
+    iterator insert( const_iterator pos, const T& value );
+    iterator insert( const_iterator pos, T&& value );
+    iterator insert( const_iterator pos, size_type count, const T& value );
+    template< std::input_iterator InputIt >
+    iterator insert( const_iterator pos, InputIt first, InputIt last );
+    iterator insert( const_iterator pos, std::initializer_list<T> ilist );
+    template< std::ranges::input_range R >
+        requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+    iterator insert_range( const_iterator pos, R&& rg );
+
+    template< class... Args >
+    iterator emplace( const_iterator pos, Args&&... args );
+
+    iterator erase( const_iterator pos );
+    iterator erase( const_iterator first, const_iterator last );
+
+    void push_back( const T& value );
+    void push_back( T&& value );
+
+    template< std::ranges::input_range R >
+        requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+    void append_range( R&& rg );
+
+    template< class... Args >
+    reference emplace_back( Args&&... args );
+
+    void pop_back();
+
+    void resize( size_type count );
+    void resize( size_type count, const value_type& value );
+    void resize_for_overwrite( size_type count );
+
+    void swap( small_vector& other );
+
+private:
+    pointer inline_data() noexcept { return reinterpret_cast<pointer>(m_buffer); }
+    const_pointer inline_data() const noexcept { return reinterpret_cast<const_pointer>(m_buffer); }
+
+    void release() noexcept;
+    void steal_or_move(small_vector& other);
+    void reallocate(size_type new_cap);
+    size_type recommend(size_type new_size) const;
+    template< class Construct >
+    iterator insert_with(size_type index, size_type count, Construct construct);
+
+    pointer m_arr;
+    size_type m_size;
+    size_type m_capacity;
+    Allocator m_alloc;
+    alignas(T) unsigned char m_buffer[sizeof(T) * N];
+};
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector() noexcept(noexcept(Allocator()))
+    : m_arr(inline_data()), m_size(0ul), m_capacity(N), m_alloc() {}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(const Allocator& alloc) noexcept
+    : m_arr(inline_data()), m_size(0ul), m_capacity(N), m_alloc(alloc) {}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(size_type count, const T& value, const Allocator& alloc)
+    : small_vector(alloc)
+{
+    insert(cend(), count, value);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(size_type count, const Allocator& alloc)
+    : small_vector(alloc)
+{
+    resize(count);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+template< std::input_iterator InputIt >
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(InputIt first, InputIt last, const Allocator& alloc)
+    : small_vector(alloc)
+{
+    append_range(std::ranges::subrange(first, last));
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(const small_vector& other)
+    : small_vector(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator()))
+{
+    append_range(other);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(const small_vector& other, const Allocator& alloc)
+    : small_vector(alloc)
+{
+    append_range(other);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(small_vector&& other)
+    noexcept(std::is_nothrow_move_constructible_v<T>)
+    : small_vector(other.m_alloc)
+{
+    steal_or_move(other);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(small_vector&& other, const Allocator& alloc)
+    : small_vector(alloc)
+{
+    if (m_alloc == other.m_alloc) steal_or_move(other);
+    else
+    {
+        insert(cend(), std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        other.clear();
+    }
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>::small_vector(std::initializer_list<T> init, const Allocator& alloc)
+    : small_vector(alloc)
+{
+    append_range(init);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>::~small_vector()
+{
+    release();
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>& small_vector<T, N, Allocator, GrowthPolicy>::operator=(const small_vector& other)
+{
+    if (this != &other)
+    {
+        if constexpr (std::allocator_traits<allocator_type>::propagate_on_container_copy_assignment::value)
+        {
+            if (m_alloc != other.m_alloc)
+            {
+                release();
+                m_arr = inline_data();
+                m_size = 0ul;
+                m_capacity = N;
+            }
+            m_alloc = other.m_alloc;
+        }
+
+        assign_range(other);
+    }
+
+    return *this;
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>& small_vector<T, N, Allocator, GrowthPolicy>::operator=(small_vector&& other)
+{
+    if (this != &other)
+    {
+        constexpr bool propagate = std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value;
+
+        if (propagate || m_alloc == other.m_alloc)
+        {
+            release();
+            m_arr = inline_data();
+            m_size = 0ul;
+            m_capacity = N;
+
+            if constexpr (propagate) m_alloc = std::move(other.m_alloc);
+            steal_or_move(other);
+        }
+        else
+        {
+            assign(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+            other.clear();
+        }
+    }
+
+    return *this;
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+small_vector<T, N, Allocator, GrowthPolicy>& small_vector<T, N, Allocator, GrowthPolicy>::operator=(std::initializer_list<value_type> ilist)
+{
+    assign(ilist.begin(), ilist.end());
+    return *this;
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::assign(size_type count, const T& value)
+{
+    const value_type copy(value);
+    clear();
+    insert(cend(), count, copy);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+template< std::input_iterator InputIt >
+void small_vector<T, N, Allocator, GrowthPolicy>::assign(InputIt first, InputIt last)
+{
+    assign_range(std::ranges::subrange(first, last));
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::assign(std::initializer_list<T> ilist)
+{
+    assign_range(ilist);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+template< std::ranges::input_range R >
+    requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+void small_vector<T, N, Allocator, GrowthPolicy>::assign_range(R&& rg)
+{
+    clear();
+    if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>)
+        reserve(static_cast<size_type>(std::ranges::distance(rg)));
+
+    append_range(std::forward<R>(rg));
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+typename small_vector<T, N, Allocator, GrowthPolicy>::reference small_vector<T, N, Allocator, GrowthPolicy>::at(size_type pos)
+{
+    if (pos >= size()) throw std::out_of_range("Index out of bounds");
+    return *(m_arr + pos);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+typename small_vector<T, N, Allocator, GrowthPolicy>::const_reference small_vector<T, N, Allocator, GrowthPolicy>::at(size_type pos) const
+{
+    if (pos >= size()) throw std::out_of_range("Index out of bounds");
+    return *(m_arr + pos);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::reserve(size_type new_cap)
+{
+    if (new_cap > max_size()) throw std::length_error("New capacity is to much");
+    if (new_cap <= m_capacity) return;
+
+    reallocate(new_cap);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::shrink_to_fit()
+{
+    if (is_small() || m_size == m_capacity) return;
+
+    if (m_size > N)
+    {
+        reallocate(m_size);
+        return;
+    }
+
+    // Everything fits inline again, give the heap block back
+    base_vector::move_into(m_alloc, m_arr, m_arr + m_size, inline_data());
+    base_vector::destroy_range(m_alloc, m_arr, m_arr + m_size);
+    std::allocator_traits<allocator_type>::deallocate(m_alloc, m_arr, m_capacity);
+
+    m_arr = inline_data();
+    m_capacity = N;
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::clear() noexcept
+{
+    base_vector::destroy_range(m_alloc, m_arr, m_arr + m_size);
+    m_size = 0ul;
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+typename small_vector<T, N, Allocator, GrowthPolicy>::iterator small_vector<T, N, Allocator, GrowthPolicy>::insert(const_iterator pos, const T& value)
+{
+    return emplace(pos, value);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+typename small_vector<T, N, Allocator, GrowthPolicy>::iterator small_vector<T, N, Allocator, GrowthPolicy>::insert(const_iterator pos, T&& value)
+{
+    return emplace(pos, std::move(value));
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+typename small_vector<T, N, Allocator, GrowthPolicy>::iterator small_vector<T, N, Allocator, GrowthPolicy>::insert(const_iterator pos,
+    size_type count, const T& value)
+{
+    const size_type index = pos - cbegin();
+    const value_type copy(value);
+
+    return insert_with(index, count,
+        [&](pointer dest) { base_vector::construct_fill(m_alloc, dest, count, copy); });
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+template< std::input_iterator InputIt >
+typename small_vector<T, N, Allocator, GrowthPolicy>::iterator small_vector<T, N, Allocator, GrowthPolicy>::insert(const_iterator pos,
+    InputIt first, InputIt last)
+{
+    return insert_range(pos, std::ranges::subrange(first, last));
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+typename small_vector<T, N, Allocator, GrowthPolicy>::iterator small_vector<T, N, Allocator, GrowthPolicy>::insert(const_iterator pos,
+    std::initializer_list<T> ilist)
+{
+    return insert_range(pos, ilist);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+template< std::ranges::input_range R >
+    requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+typename small_vector<T, N, Allocator, GrowthPolicy>::iterator small_vector<T, N, Allocator, GrowthPolicy>::insert_range(const_iterator pos,
+    R&& rg)
+{
+    const size_type index = pos - cbegin();
+
+    if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>)
+    {
+        const size_type count = static_cast<size_type>(std::ranges::distance(rg));
+
+        return insert_with(index, count,
+            [&](pointer dest) { base_vector::construct_copy(m_alloc, std::ranges::begin(rg), count, dest); });
+    }
+    else
+    {
+        const size_type old_size = m_size;
+        try
+        {
+            for (auto&& value : rg)
+                emplace_back(std::forward<decltype(value)>(value));
+        }
+        catch (...)
+        {
+            erase(cbegin() + old_size, cend());
+            throw;
+        }
+
+        std::rotate(begin() + index, begin() + old_size, end());
+        return begin() + index;
+    }
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+template< class... Args >
+typename small_vector<T, N, Allocator, GrowthPolicy>::iterator small_vector<T, N, Allocator, GrowthPolicy>::emplace(const_iterator pos,
+    Args&&... args)
+{
+    const size_type index = pos - cbegin();
+
+    // args may refer to an element that is about to be shifted
+    if (index != m_size && m_size < m_capacity)
+    {
+        value_type tmp(std::forward<Args>(args)...);
+        return insert_with(index, 1ul,
+            [&](pointer dest) { std::allocator_traits<allocator_type>::construct(m_alloc, dest, std::move(tmp)); });
+    }
+
+    return insert_with(index, 1ul,
+        [&](pointer dest) { std::allocator_traits<allocator_type>::construct(m_alloc, dest, std::forward<Args>(args)...); });
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+typename small_vector<T, N, Allocator, GrowthPolicy>::iterator small_vector<T, N, Allocator, GrowthPolicy>::erase(const_iterator pos)
+{
+    const size_type index = pos - cbegin();
+
+    base_vector::erase_in_place(m_alloc, m_arr, m_size, index, 1ul);
+    return iterator(m_arr + index);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+typename small_vector<T, N, Allocator, GrowthPolicy>::iterator small_vector<T, N, Allocator, GrowthPolicy>::erase(const_iterator first,
+    const_iterator last)
+{
+    const size_type index = first - cbegin();
+    const size_type count = last - first;
+
+    base_vector::erase_in_place(m_alloc, m_arr, m_size, index, count);
+    return iterator(m_arr + index);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::push_back(const T& value)
+{
+    emplace_back(value);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::push_back(T&& value)
+{
+    emplace_back(std::move(value));
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+template< std::ranges::input_range R >
+    requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+void small_vector<T, N, Allocator, GrowthPolicy>::append_range(R&& rg)
+{
+    insert_range(cend(), std::forward<R>(rg));
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+template< class... Args >
+typename small_vector<T, N, Allocator, GrowthPolicy>::reference small_vector<T, N, Allocator, GrowthPolicy>::emplace_back(Args&&... args)
+{
+    if (m_size < m_capacity)
+    {
+        std::allocator_traits<allocator_type>::construct(m_alloc, m_arr + m_size, std::forward<Args>(args)...);
+        return m_arr[m_size++];
+    }
+
+    return *insert_with(m_size, 1ul,
+        [&](pointer dest) { std::allocator_traits<allocator_type>::construct(m_alloc, dest, std::forward<Args>(args)...); });
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::pop_back()
+{
+    std::allocator_traits<allocator_type>::destroy(m_alloc, m_arr + --m_size);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::resize(size_type count)
+{
+    if (count < m_size)
+    {
+        base_vector::destroy_range(m_alloc, m_arr + count, m_arr + m_size);
+        m_size = count;
+        return;
+    }
+
+    const size_type extra = count - m_size;
+    insert_with(m_size, extra, [&](pointer dest) { base_vector::construct_value(m_alloc, dest, extra); });
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::resize(size_type count, const value_type& value)
+{
+    if (count < m_size)
+    {
+        base_vector::destroy_range(m_alloc, m_arr + count, m_arr + m_size);
+        m_size = count;
+    }
+    else insert(cend(), count - m_size, value);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::resize_for_overwrite(size_type count)
+{
+    if (count < m_size)
+    {
+        base_vector::destroy_range(m_alloc, m_arr + count, m_arr + m_size);
+        m_size = count;
+        return;
+    }
+
+    const size_type extra = count - m_size;
+    insert_with(m_size, extra, [&](pointer dest) { base_vector::construct_default(m_alloc, dest, extra); });
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::swap(small_vector& other)
+{
+    if (this == &other) return;
+
+    if (!is_small() && !other.is_small())
+    {
+        using std::swap;
+        swap(m_arr, other.m_arr);
+        swap(m_size, other.m_size);
+        swap(m_capacity, other.m_capacity);
+        if constexpr (std::allocator_traits<allocator_type>::propagate_on_container_swap::value)
+            swap(m_alloc, other.m_alloc);
+        return;
+    }
+
+    small_vector tmp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(tmp);
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::release() noexcept
+{
+    base_vector::destroy_range(m_alloc, m_arr, m_arr + m_size);
+    if (!is_small())
+        std::allocator_traits<allocator_type>::deallocate(m_alloc, m_arr, m_capacity);
+}
+
+// Takes over other's heap block, or moves its elements when they live inline.
+// Expects *this to be empty and inline.
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::steal_or_move(small_vector& other)
+{
+    if (other.is_small())
+    {
+        base_vector::move_into(m_alloc, other.m_arr, other.m_arr + other.m_size, m_arr);
+        m_size = other.m_size;
+        other.clear();
+        return;
+    }
+
+    m_arr = other.m_arr;
+    m_size = other.m_size;
+    m_capacity = other.m_capacity;
+
+    other.m_arr = other.inline_data();
+    other.m_size = 0ul;
+    other.m_capacity = N;
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+void small_vector<T, N, Allocator, GrowthPolicy>::reallocate(size_type new_cap)
+{
+    pointer new_arr = std::allocator_traits<allocator_type>::allocate(m_alloc, new_cap);
+    try
+    {
+        base_vector::move_into(m_alloc, m_arr, m_arr + m_size, new_arr);
+    }
+    catch (...)
+    {
+        std::allocator_traits<allocator_type>::deallocate(m_alloc, new_arr, new_cap);
+        throw;
+    }
+
+    release();
+
+    m_arr = new_arr;
+    m_capacity = new_cap;
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+typename small_vector<T, N, Allocator, GrowthPolicy>::size_type small_vector<T, N, Allocator, GrowthPolicy>::recommend(size_type new_size) const
+{
+    if (new_size > max_size()) throw std::length_error("New capacity is to much");
+
+    const size_type new_cap = GrowthPolicy::next_capacity(m_capacity, new_size, sizeof(T));
+    return std::max(new_size, std::min(new_cap, max_size()));
+}
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+template< class Construct >
+typename small_vector<T, N, Allocator, GrowthPolicy>::iterator small_vector<T, N, Allocator, GrowthPolicy>::insert_with(size_type index,
+    size_type count, Construct construct)
+{
+    if (count == 0ul) return iterator(m_arr + index);
+
+    if (m_size + count <= m_capacity)
+    {
+        base_vector::insert_in_place(m_alloc, m_arr, m_size, index, count, construct);
+        return iterator(m_arr + index);
+    }
+
+    const size_type new_cap = recommend(m_size + count);
+    pointer new_arr = std::allocator_traits<allocator_type>::allocate(m_alloc, new_cap);
+    try
+    {
+        base_vector::relocate_around(m_alloc, m_arr, m_size, index, count, new_arr, construct);
+    }
+    catch (...)
+    {
+        std::allocator_traits<allocator_type>::deallocate(m_alloc, new_arr, new_cap);
+        throw;
+    }
+
+    const size_type new_size = m_size + count;
+    release();
+
+    m_arr = new_arr;
+    m_size = new_size;
+    m_capacity = new_cap;
+
+    return iterator(m_arr + index);
+}
+
+#endif //! OWN_SMALL_VECTOR_H
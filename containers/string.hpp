@@ -2,20 +2,36 @@
 #define BASIC_STRING_H
 
 
+#include <bit>
+#include <limits>
 #include <memory>
+#include <string>
 #include <iterator>
 #include <iostream>
 #include <algorithm>
+#include <stdexcept>
+#include <concepts>
+#include <type_traits>
 
+#include "growth_policy.hpp"
+#include "string_view.hpp"
+
+template< class String, class Lhs, class Rhs >
+class string_concat;
+
+// Strings up to short_capacity characters (23 chars on 64-bit targets) live inside the object.
+// The object is three words: pointer, size and capacity of a heap buffer, or the characters
+// themselves. In the short form the last character holds short_capacity - size, which turns
+// into the terminating zero for a full short string; the heap form keeps a flag in that byte.
 template <
     class CharT,
     class Traits = std::char_traits<CharT>,
     class Allocator = std::allocator<CharT>
-> class basic_string 
+> class basic_string
 {
 private:
 	class bs_iter;
-	
+
 public:
 	// Member types
 	using traits_type = Traits;
@@ -31,300 +47,697 @@ public:
 	using const_iterator = const_pointer;
 	using reverse_iterator = std::reverse_iterator<iterator>;
 	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
-	
+
+	static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+	using alloc_traits = std::allocator_traits<Allocator>;
+	using search = string_search<CharT, Traits>;
+	using view_type = basic_string_view<CharT, Traits>;
+	using growth_policy = growth_2x;
+
+	struct long_rep
+	{
+		pointer data;
+		size_type size;
+		size_type capacity_word;	// capacity with the heap flag in the object's last byte
+	};
+
+	static_assert(std::is_trivial_v<CharT> && sizeof(long_rep) % sizeof(CharT) == 0, "Unsupported character type");
+
+	static constexpr size_type local_length = sizeof(long_rep) / sizeof(CharT);
+
+public:
+	// longest string kept without allocation
+	static constexpr size_type short_capacity = local_length - 1;
+
 	// Member functions
 	basic_string() noexcept(noexcept(Allocator())) : basic_string(Allocator()) {}
-	explicit basic_string( const Allocator& alloc ) : m_alloc(alloc) {}
-	basic_string( size_type count, CharT ch, const Allocator& alloc = Allocator() )
-	{
-		m_data = std::allocator_traits<allocator_type>::allocate(m_alloc, m_size * sizeof(CharT));
-		m_size = count;
-		m_capacity = count;
-		
-		for (int i = 0; i < count; i++)
-			std::allocator_traits<allocator_type>::construct(m_alloc, m_data + i, ch);
-	}
-	
-	basic_string( const basic_string& other, size_type pos, const Allocator& alloc = Allocator() )
-	{
-		m_size = other.size() - pos;
-		m_capacity = other.size() - pos;
-		m_data = std::allocator_traits<allocator_type>::allocate(m_alloc, m_size * sizeof(CharT));
-		
-		for (int i = 0; i < m_size; i++)
-			std::allocator_traits<allocator_type>::construct(m_alloc, m_data + i, other[i]);
-	}
-	
-	basic_string( const CharT* s, size_type count, const Allocator& alloc = Allocator() )
-	{
-		m_size = count;
-		m_capacity = count;
-		
-		m_data = std::allocator_traits<allocator_type>::allocate(m_alloc, m_size * sizeof(CharT));
-		
-		for (int i = 0; i < count; i++)
-			std::allocator_traits<allocator_type>::construct(m_alloc, m_data + i, s[i]);
-	}
-	
-	basic_string( const CharT* s, const Allocator& alloc = Allocator() )
-	{
-		m_data = s;
-		m_size = std::char_traits<CharT>::length(s);
-		m_capacity = std::char_traits<CharT>::length(s);
-	}
-	
-	template< class InputIt >
-	basic_string( InputIt first, InputIt last, const Allocator& alloc = Allocator() )
-	{
-		m_size = std::distance(first, last);
-		m_capacity = std::distance(first, last);
-		
-		m_data = std::allocator_traits<allocator_type>::allocate(m_alloc, m_size * sizeof(CharT));
-		
-		int counter = 0;
-		for (; first != last; ++first)
+	explicit basic_string( const Allocator& alloc ) noexcept : m_alloc(alloc) { set_short_size(0); }
+	basic_string( size_type count, CharT ch, const Allocator& alloc = Allocator() ) : m_alloc(alloc)
+	{
+		traits_type::assign(init_storage(count), count, ch);
+	}
+
+	basic_string( const basic_string& other, size_type pos, const Allocator& alloc = Allocator() ) : m_alloc(alloc)
+	{
+		if (pos > other.size()) throw std::out_of_range("Position out of bounds");
+		init(other.data() + pos, other.size() - pos);
+	}
+
+	basic_string( const basic_string& other, size_type pos, size_type count, const Allocator& alloc = Allocator() ) : m_alloc(alloc)
+	{
+		if (pos > other.size()) throw std::out_of_range("Position out of bounds");
+		init(other.data() + pos, std::min(count, other.size() - pos));
+	}
+
+	basic_string( const CharT* s, size_type count, const Allocator& alloc = Allocator() ) : m_alloc(alloc)
+	{
+		init(s, count);
+	}
+
+	basic_string( const CharT* s, const Allocator& alloc = Allocator() ) : m_alloc(alloc)
+	{
+		init(s, traits_type::length(s));
+	}
+
+	explicit basic_string( view_type v, const Allocator& alloc = Allocator() ) : m_alloc(alloc)
+	{
+		init(v.data(), v.size());
+	}
+
+	template< std::input_iterator InputIt >
+	basic_string( InputIt first, InputIt last, const Allocator& alloc = Allocator() ) : m_alloc(alloc)
+	{
+		if constexpr (std::forward_iterator<InputIt>)
+		{
+			std::copy(first, last, init_storage(static_cast<size_type>(std::distance(first, last))));
+		}
+		else
 		{
-			std::allocator_traits<allocator_type>::construct(m_alloc, m_data + counter, *first);
-			++counter;
+			set_short_size(0);
+			try
+			{
+				for (; first != last; ++first) push_back(*first);
+			}
+			catch (...)
+			{
+				release();
+				throw;
+			}
 		}
-			
 	}
-	
+
 	basic_string( const basic_string& other )
+		: m_alloc(alloc_traits::select_on_container_copy_construction(other.m_alloc))
 	{
-		m_data = std::allocator_traits<allocator_type>::allocate(m_alloc, other.m_size * sizeof(CharT));
-		m_size = other.m_size;
-		m_capacity = other.m_capacity;
-		
-		int counter = 0;
-		for (auto it = other.begin(); it != other.end(); ++it)
-		{
-			m_data = std::allocator_traits<allocator_type>::construct(m_alloc, m_data + counter, *it);
-			++counter;
-		}
-		
+		init(other.data(), other.size());
 	}
-	
+
 	basic_string( const basic_string& other, const Allocator& alloc ) : m_alloc(alloc)
 	{
-		m_data = std::allocator_traits<allocator_type>::allocate(m_alloc, other.m_size * sizeof(CharT));
-		m_size = other.m_size;
-		m_capacity = other.m_capacity;
-		
-		int counter = 0;
-		for (auto it = other.begin(); it != other.end(); ++it)
+		init(other.data(), other.size());
+	}
+
+	basic_string( basic_string&& other ) noexcept : m_rep(other.m_rep), m_alloc(std::move(other.m_alloc))
+	{
+		other.set_short_size(0);
+	}
+
+	basic_string( basic_string&& other, const Allocator& alloc ) : m_alloc(alloc)
+	{
+		if (!other.is_long() || m_alloc == other.m_alloc)
 		{
-			m_data = std::allocator_traits<allocator_type>::construct(m_alloc, m_data + counter, *it);
-			++counter;
+			m_rep = other.m_rep;
+			other.set_short_size(0);
 		}
+		else init(other.data(), other.size());
 	}
-	
-	basic_string( basic_string&& other ) noexcept
-	{
-		m_size = other.m_size;
-		m_capacity = other.m_capacity;
-		m_data = other.m_data;
-		
-		other.clear();
-		
-		other.m_data = nullptr;
-		other.m_size = 0;
-		other.m_capacity = 0;
-	}
-	
-	basic_string( basic_string&& other, const Allocator& alloc )
-	{
-		m_size = other.m_size;
-		m_capacity = other.m_capacity;
-		m_data = other.m_data;
-		m_alloc = std::move(other.m_alloc);
-		
-		other.clear();
-		
-		other.m_data = nullptr;
-		other.m_size = 0;
-		other.m_capacity = 0;
-	}
-	
+
 	basic_string( std::initializer_list<CharT> ilist, const Allocator& alloc = Allocator() ) : m_alloc(alloc)
 	{
-		m_size = ilist.size();
-		m_capacity = ilist.size();
-		m_data = std::allocator_traits<allocator_type>::allocate(m_alloc, m_size * sizeof(CharT));
-		
-		int counter = 0;
-		for (auto it = ilist.begin(); it != ilist.end(); ++it)
-		{
-			std::allocator_traits<allocator_type>::construct(m_alloc, m_data+counter, *it);
-			++counter;
-		}
+		init(ilist.begin(), ilist.size());
+	}
+
+	// the single allocation of a + b + c + ...
+	template< class Lhs, class Rhs >
+	basic_string( const string_concat<basic_string, Lhs, Rhs>& expr, const Allocator& alloc = Allocator() ) : m_alloc(alloc)
+	{
+		expr.write(init_storage(expr.size()));
 	}
-	
+
 	~basic_string()
 	{
-		clear();
-		std::allocator_traits<allocator_type>::deallocate(m_alloc, const_cast<CharT*>(m_data), m_size * sizeof(CharT));
+		release();
 	}
-	
+
 	basic_string& operator=( const basic_string& str )
 	{
 		if (this == &str) return *this;
-		
-		if (capacity() > str.size()) 
-			std::allocator_traits<allocator_type>::deallocate(m_alloc, m_data, capacity());
-		if (str.size() > capacity())
-			m_data = std::allocator_traits<allocator_type>::allocate(m_alloc, str.size() * sizeof(CharT));
-		
-		std::copy(str.begin(), str.end(), m_data);
-		
-		m_size = str.m_size;
-		m_capacity = str.m_capacity;
+
+		if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+		{
+			if (m_alloc != str.m_alloc)
+			{
+				release();
+				set_short_size(0);
+			}
+			m_alloc = str.m_alloc;
+		}
+
+		assign_chars(str.data(), str.size());
+		return *this;
+	}
+
+	basic_string& operator=( basic_string&& str )
+		noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)
+	{
+		if (this == &str) return *this;
+
+		if (alloc_traits::propagate_on_container_move_assignment::value || m_alloc == str.m_alloc)
+		{
+			release();
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+				m_alloc = std::move(str.m_alloc);
+			m_rep = str.m_rep;
+			str.set_short_size(0);
+		}
+		else assign_chars(str.data(), str.size());
+
 		return *this;
 	}
-	
-	basic_string& operator=( basic_string&& str ) noexcept 
-	{
-		if(this == &str) return *this;
-		
-		clear();
-		
-		m_data = str.m_data;
-		m_size = str.m_size;
-		m_capacity = str.m_capacity;
-		m_alloc = std::move(str.m_alloc);
-		
-		str.m_data = nullptr;
-		str.m_size = 0;
-		str.m_capacity = 0;
-	}
-	
+
 	basic_string& operator=( const CharT* s )
 	{
-		if (this == &s) return *this;
-		
-		m_data = s;
-		m_size = std::char_traits<CharT>::length(s);
-		m_capacity = std::char_traits<CharT>::length(s);
-		
+		assign_chars(s, traits_type::length(s));
 		return *this;
 	}
-	
+
 	allocator_type get_allocator() const { return m_alloc; }
-	
+
+	operator view_type() const noexcept { return view_type(data(), size()); }
+
 	// Element access
-	CharT& at( size_type pos ) { return (const_cast<char*>(m_data)[pos]); }
-	const CharT& at( size_type pos ) const { return m_data[pos]; }
-	
-	CharT& operator[]( size_type pos ) { return (const_cast<char*>(m_data)[pos]); }
-	const CharT& operator[]( size_type pos ) const { return m_data[pos]; } 
-	
+	CharT& at( size_type pos )
+	{
+		if (pos >= size()) throw std::out_of_range("Index out of bounds");
+		return data()[pos];
+	}
+	const CharT& at( size_type pos ) const
+	{
+		if (pos >= size()) throw std::out_of_range("Index out of bounds");
+		return data()[pos];
+	}
+
+	CharT& operator[]( size_type pos ) { return data()[pos]; }
+	const CharT& operator[]( size_type pos ) const { return data()[pos]; }
+
 	CharT& front() { return this->operator[](0); }
 	const CharT& front() const { return this->operator[](0); }
-	
+
 	CharT& back() { return this->operator[](size() - 1); }
 	const CharT& back() const { return this->operator[](size() - 1); }
-	
-	const CharT* data() const { return m_data; }
-	CharT* data() noexcept { return const_cast<char*>(m_data); }
-	
+
+	const CharT* data() const noexcept { return is_long() ? std::to_address(m_rep.l.data) : m_rep.s; }
+	CharT* data() noexcept { return is_long() ? std::to_address(m_rep.l.data) : m_rep.s; }
+	const CharT* c_str() const noexcept { return data(); }
+
 	// Iterators
-	iterator begin() { return m_data; }
-	const_iterator begin() const { return m_data; }
-	const_iterator cbegin() const noexcept { return m_data; }
-	
-	iterator end() { return m_data + m_size; }
-	const_iterator end() const { return m_data + m_size; }
-	const_iterator cend() const noexcept { return m_data + m_size; }
-	
+	iterator begin() { return data(); }
+	const_iterator begin() const { return data(); }
+	const_iterator cbegin() const noexcept { return data(); }
+
+	iterator end() { return data() + size(); }
+	const_iterator end() const { return data() + size(); }
+	const_iterator cend() const noexcept { return data() + size(); }
+
 	reverse_iterator rbegin() noexcept { return reverse_iterator( end() ); }
-	const_reverse_iterator rbegin() const noexcept { return reverse_iterator( end() ); }
-	const_reverse_iterator crbegin() const noexcept { return reverse_iterator( end() ); }
-	
+	const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator( end() ); }
+	const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator( end() ); }
+
 	reverse_iterator rend() noexcept {return reverse_iterator( begin() ); }
-	const_reverse_iterator rend() const noexcept {return reverse_iterator( begin() ); }
-	const_reverse_iterator crend() const noexcept {return reverse_iterator( begin() ); }
-	
+	const_reverse_iterator rend() const noexcept {return const_reverse_iterator( begin() ); }
+	const_reverse_iterator crend() const noexcept {return const_reverse_iterator( begin() ); }
+
 	// Capacity
-	bool empty() const { return m_size == 0; }
-	size_type size() const { return m_size; }
-	size_type length() const { return m_size; }
-	size_type max_size() const { return std::allocator_traits<allocator_type>::max_size(m_alloc); }
-	
+	bool empty() const noexcept { return size() == 0; }
+	size_type size() const noexcept
+	{
+		return is_long() ? m_rep.l.size : short_capacity - static_cast<size_type>(m_rep.s[short_capacity]);
+	}
+	size_type length() const noexcept { return size(); }
+	size_type max_size() const noexcept
+	{
+		return std::min<size_type>(alloc_traits::max_size(m_alloc), std::numeric_limits<size_type>::max() >> 8) - 1;
+	}
+
 	void reserve(size_type new_cap)
 	{
 		if (new_cap > max_size())
 		{
 			throw std::length_error("Capacity overflow");
 		}
-		
-		if (new_cap <= m_capacity)
+
+		if (new_cap <= capacity())
 		{
 			return;
 		}
-		
-		CharT* new_data = std::allocator_traits<allocator_type>::allocate(m_alloc, new_cap * sizeof(CharT));
-		
-		for (size_type i = 0; i < m_size; i++)
-		{
-			std::allocator_traits<allocator_type>::construct(m_alloc, new_data + i, m_data[i]);
-			std::allocator_traits<allocator_type>::destroy(m_alloc, m_data + i);
-		}
-		
-		std::allocator_traits<allocator_type>::allocate(m_alloc, m_data, m_capacity * sizeof(CharT));
-		m_data = new_data;
-		m_capacity = new_cap;
-	}
-	
-	size_type capacity() const { return m_capacity; }
-	
+
+		reallocate(recommend(new_cap));
+	}
+
+	size_type capacity() const noexcept { return is_long() ? decode_capacity(m_rep.l.capacity_word) : short_capacity; }
+
 	void shrink_to_fit()
 	{
-		if (m_capacity == m_size) return;
-		
-		allocator_type new_allocator = get_allocator();
-		const CharT* new_data = std::allocator_traits<allocator_type>::allocate(new_allocator, m_size);
-		
-		std::copy(begin(), end(), new_data);
-		std::allocator_traits<allocator_type>::deallocate(m_alloc, m_data, m_capacity);
-		
-		m_data = new_data;
-		m_capacity = m_size;
-	}
-	
-	
+		if (!is_long() || capacity() == size()) return;
+
+		const size_type len = size();
+		if (len > short_capacity)
+		{
+			reallocate(len);
+			return;
+		}
+
+		// back into the object
+		const long_rep old = m_rep.l;
+		traits_type::copy(m_rep.s, std::to_address(old.data), len);
+		set_short_size(len);
+		alloc_traits::deallocate(m_alloc, old.data, decode_capacity(old.capacity_word) + 1);
+	}
+
+
 	// Modifiers
-	void clear()
-	{
-		for(int i = 0; i < m_size; ++i)
-			std::allocator_traits<allocator_type>::destroy(m_alloc, m_data + i);
-		
-		m_data = nullptr;
-		m_size = 0;
-	}
-	
-	
-	
-	
-	
-	
-	
-	
+	void clear() noexcept
+	{
+		set_size(0);
+	}
+
+	void push_back( CharT ch )
+	{
+		const size_type len = size();
+		if (len == capacity()) reallocate(recommend(len + 1));
+		traits_type::assign(data()[len], ch);
+		set_size(len + 1);
+	}
+
+	basic_string& append( size_type count, CharT ch )
+	{
+		append_with(count, [&]( CharT* out ) { traits_type::assign(out, count, ch); });
+		return *this;
+	}
+
+	basic_string& append( const basic_string& str ) { return append(str.data(), str.size()); }
+
+	basic_string& append( const basic_string& str, size_type pos, size_type count = npos )
+	{
+		if (pos > str.size()) throw std::out_of_range("Position out of bounds");
+		return append(str.data() + pos, std::min(count, str.size() - pos));
+	}
+
+	basic_string& append( const CharT* s, size_type count )
+	{
+		append_with(count, [&]( CharT* out ) { traits_type::copy(out, s, count); });
+		return *this;
+	}
+
+	basic_string& append( const CharT* s ) { return append(s, traits_type::length(s)); }
+
+	basic_string& append( view_type v ) { return append(v.data(), v.size()); }
+
+	template< std::input_iterator InputIt >
+	basic_string& append( InputIt first, InputIt last )
+	{
+		if constexpr (std::contiguous_iterator<InputIt> && std::is_same_v<std::iter_value_t<InputIt>, CharT>)
+		{
+			return append(std::to_address(first), static_cast<size_type>(last - first));
+		}
+		else if constexpr (std::forward_iterator<InputIt>)
+		{
+			// the range may be part of this string, which a reallocation would free
+			const basic_string chars(first, last, m_alloc);
+			return append(chars);
+		}
+		else
+		{
+			for (; first != last; ++first) push_back(*first);
+			return *this;
+		}
+	}
+
+	basic_string& append( std::initializer_list<CharT> ilist ) { return append(ilist.begin(), ilist.size()); }
+
+	template< class Lhs, class Rhs >
+	basic_string& append( const string_concat<basic_string, Lhs, Rhs>& expr )
+	{
+		append_with(expr.size(), [&]( CharT* out ) { expr.write(out); });
+		return *this;
+	}
+
+	basic_string& operator+=( const basic_string& str ) { return append(str); }
+	basic_string& operator+=( CharT ch ) { push_back(ch); return *this; }
+	basic_string& operator+=( const CharT* s ) { return append(s); }
+	basic_string& operator+=( view_type v ) { return append(v); }
+	basic_string& operator+=( std::initializer_list<CharT> ilist ) { return append(ilist); }
+	template< class Lhs, class Rhs >
+	basic_string& operator+=( const string_concat<basic_string, Lhs, Rhs>& expr ) { return append(expr); }
+
+	void swap( basic_string& other ) noexcept
+	{
+		std::swap(m_rep, other.m_rep);
+		if constexpr (alloc_traits::propagate_on_container_swap::value)
+		{
+			using std::swap;
+			swap(m_alloc, other.m_alloc);
+		}
+	}
+
+
+
+	// Search
+	size_type find( view_type v, size_type pos = 0 ) const noexcept { return find(v.data(), pos, v.size()); }
+	size_type find( const CharT* s, size_type pos, size_type count ) const noexcept { return search::find(data(), size(), s, count, pos); }
+	size_type find( const CharT* s, size_type pos = 0 ) const noexcept { return find(s, pos, Traits::length(s)); }
+	size_type find( CharT ch, size_type pos = 0 ) const noexcept { return find(&ch, pos, 1); }
+
+	size_type rfind( view_type v, size_type pos = npos ) const noexcept { return rfind(v.data(), pos, v.size()); }
+	size_type rfind( const CharT* s, size_type pos, size_type count ) const noexcept { return search::rfind(data(), size(), s, count, pos); }
+	size_type rfind( const CharT* s, size_type pos = npos ) const noexcept { return rfind(s, pos, Traits::length(s)); }
+	size_type rfind( CharT ch, size_type pos = npos ) const noexcept { return rfind(&ch, pos, 1); }
+
+	size_type find_first_of( view_type v, size_type pos = 0 ) const noexcept { return find_first_of(v.data(), pos, v.size()); }
+	size_type find_first_of( const CharT* s, size_type pos, size_type count ) const noexcept { return search::find_first_of(data(), size(), s, count, pos); }
+	size_type find_first_of( const CharT* s, size_type pos = 0 ) const noexcept { return find_first_of(s, pos, Traits::length(s)); }
+	size_type find_first_of( CharT ch, size_type pos = 0 ) const noexcept { return find(&ch, pos, 1); }
+
+	size_type find_last_of( view_type v, size_type pos = npos ) const noexcept { return find_last_of(v.data(), pos, v.size()); }
+	size_type find_last_of( const CharT* s, size_type pos, size_type count ) const noexcept { return search::find_last_of(data(), size(), s, count, pos); }
+	size_type find_last_of( const CharT* s, size_type pos = npos ) const noexcept { return find_last_of(s, pos, Traits::length(s)); }
+	size_type find_last_of( CharT ch, size_type pos = npos ) const noexcept { return rfind(&ch, pos, 1); }
+
+	size_type find_first_not_of( view_type v, size_type pos = 0 ) const noexcept { return find_first_not_of(v.data(), pos, v.size()); }
+	size_type find_first_not_of( const CharT* s, size_type pos, size_type count ) const noexcept { return search::find_first_not_of(data(), size(), s, count, pos); }
+	size_type find_first_not_of( const CharT* s, size_type pos = 0 ) const noexcept { return find_first_not_of(s, pos, Traits::length(s)); }
+	size_type find_first_not_of( CharT ch, size_type pos = 0 ) const noexcept { return find_first_not_of(&ch, pos, 1); }
+
+	size_type find_last_not_of( view_type v, size_type pos = npos ) const noexcept { return find_last_not_of(v.data(), pos, v.size()); }
+	size_type find_last_not_of( const CharT* s, size_type pos, size_type count ) const noexcept { return search::find_last_not_of(data(), size(), s, count, pos); }
+	size_type find_last_not_of( const CharT* s, size_type pos = npos ) const noexcept { return find_last_not_of(s, pos, Traits::length(s)); }
+	size_type find_last_not_of( CharT ch, size_type pos = npos ) const noexcept { return find_last_not_of(&ch, pos, 1); }
+
+	bool contains( view_type v ) const noexcept { return find(v) != npos; }
+	bool contains( const CharT* s ) const noexcept { return find(s) != npos; }
+	bool contains( CharT ch ) const noexcept { return find(ch) != npos; }
+
+	bool starts_with( view_type v ) const noexcept { return view_type(*this).starts_with(v); }
+	bool starts_with( const CharT* s ) const noexcept { return view_type(*this).starts_with(s); }
+	bool starts_with( CharT ch ) const noexcept { return view_type(*this).starts_with(ch); }
+
+	bool ends_with( view_type v ) const noexcept { return view_type(*this).ends_with(v); }
+	bool ends_with( const CharT* s ) const noexcept { return view_type(*this).ends_with(s); }
+	bool ends_with( CharT ch ) const noexcept { return view_type(*this).ends_with(ch); }
+
+
+	// Operations
+	// a slice of an lvalue string is a view into it; a slice of a temporary owns its characters
+	view_type substr( size_type pos = 0, size_type count = npos ) const& { return view_type(*this).substr(pos, count); }
+	basic_string substr( size_type pos = 0, size_type count = npos ) && { return basic_string(view_type(*this).substr(pos, count), m_alloc); }
+
+	int compare( view_type v ) const noexcept { return view_type(*this).compare(v); }
+	int compare( size_type pos1, size_type count1, view_type v ) const { return view_type(*this).compare(pos1, count1, v); }
+	int compare( const CharT* s ) const { return view_type(*this).compare(s); }
+
+	friend bool operator==( const basic_string& lhs, const basic_string& rhs ) noexcept { return view_type(lhs) == view_type(rhs); }
+	friend bool operator==( const basic_string& lhs, const CharT* rhs ) { return view_type(lhs) == view_type(rhs); }
+	friend auto operator<=>( const basic_string& lhs, const basic_string& rhs ) noexcept { return view_type(lhs) <=> view_type(rhs); }
+	friend auto operator<=>( const basic_string& lhs, const CharT* rhs ) { return view_type(lhs) <=> view_type(rhs); }
+
+
+
+
+
+
+
+
 	// for tests
 	static void print(const basic_string& string)
 	{
-		for (int i = 0; i < string.m_size; i++)
-			std::cout << string.m_data[i];
+		for (size_type i = 0; i < string.size(); i++)
+			std::cout << string[i];
 	}
-	
+
 private:
-	// Members of the class 
-	allocator_type m_alloc;
+	// the flag sits in the top bit of the last byte: the high byte of the capacity word on
+	// little-endian targets, its low byte on big-endian ones, where the capacity is shifted up
+	static constexpr bool little_endian = std::endian::native == std::endian::little;
+	static constexpr size_type long_flag = little_endian ? size_type(0x80) << (8 * (sizeof(size_type) - 1)) : size_type(0x80);
+
+	static constexpr size_type encode_capacity( size_type cap ) noexcept { return (little_endian ? cap : cap << 8) | long_flag; }
+	static constexpr size_type decode_capacity( size_type word ) noexcept { return little_endian ? word & ~long_flag : word >> 8; }
+
+	bool is_long() const noexcept
+	{
+		return reinterpret_cast<const unsigned char*>(&m_rep)[sizeof(m_rep) - 1] & 0x80;
+	}
+
+	void set_short_size( size_type count ) noexcept
+	{
+		m_rep.s[short_capacity] = static_cast<CharT>(short_capacity - count);
+		traits_type::assign(m_rep.s[count], CharT());
+	}
+
+	void set_size( size_type count ) noexcept
+	{
+		if (is_long())
+		{
+			m_rep.l.size = count;
+			traits_type::assign(std::to_address(m_rep.l.data)[count], CharT());
+		}
+		else set_short_size(count);
+	}
+
+	// Sets up an uninitialised string of count characters and returns where they go
+	CharT* init_storage( size_type count )
+	{
+		if (count <= short_capacity)
+		{
+			set_short_size(count);
+			return m_rep.s;
+		}
+
+		if (count > max_size()) throw std::length_error("String too long");
+		pointer buffer = alloc_traits::allocate(m_alloc, count + 1);
+		m_rep.l = long_rep{ buffer, count, encode_capacity(count) };
+		traits_type::assign(std::to_address(buffer)[count], CharT());
+		return std::to_address(buffer);
+	}
+
+	void init( const CharT* s, size_type count )
+	{
+		traits_type::copy(init_storage(count), s, count);
+	}
+
+	// Moves the characters into a heap buffer for exactly new_cap characters
+	void reallocate( size_type new_cap )
+	{
+		const size_type len = size();
+		pointer buffer = alloc_traits::allocate(m_alloc, new_cap + 1);
+		traits_type::copy(std::to_address(buffer), data(), len + 1);
+
+		release();
+		m_rep.l = long_rep{ buffer, len, encode_capacity(new_cap) };
+	}
+
+	// Frees the heap buffer, if any; the representation must be reset afterwards
+	void release() noexcept
+	{
+		if (is_long()) alloc_traits::deallocate(m_alloc, m_rep.l.data, capacity() + 1);
+	}
+
+	// Capacity for at least required characters. Growth is geometric, so a string built by
+	// appends, or by reserve calls that creep up, copies each character a constant number of times
+	size_type recommend( size_type required ) const
+	{
+		if (required > max_size()) throw std::length_error("String too long");
+		return std::min<size_type>(growth_policy::next_capacity(capacity(), required, sizeof(CharT)), max_size());
+	}
+
+	// Adds count characters at the end, produced by write(destination). The old buffer is
+	// released only after write has run, so the characters may come from this string.
+	template< class Writer >
+	void append_with( size_type count, Writer write )
+	{
+		const size_type len = size();
+		if (count <= capacity() - len)
+		{
+			write(data() + len);
+			set_size(len + count);
+			return;
+		}
+
+		if (count > max_size() - len) throw std::length_error("String too long");
+		const size_type new_cap = recommend(len + count);
+		pointer buffer = alloc_traits::allocate(m_alloc, new_cap + 1);
+		CharT* out = std::to_address(buffer);
+		try
+		{
+			traits_type::copy(out, data(), len);
+			write(out + len);
+		}
+		catch (...)
+		{
+			alloc_traits::deallocate(m_alloc, buffer, new_cap + 1);
+			throw;
+		}
+		traits_type::assign(out[len + count], CharT());
+
+		release();
+		m_rep.l = long_rep{ buffer, len + count, encode_capacity(new_cap) };
+	}
+
+	// Replaces the contents with count characters from s, which may point into *this
+	void assign_chars( const CharT* s, size_type count )
+	{
+		if (count <= capacity())
+		{
+			traits_type::move(data(), s, count);
+			set_size(count);
+			return;
+		}
+
+		if (count > max_size()) throw std::length_error("String too long");
+		pointer buffer = alloc_traits::allocate(m_alloc, count + 1);
+		traits_type::copy(std::to_address(buffer), s, count);
+		traits_type::assign(std::to_address(buffer)[count], CharT());
+
+		release();
+		m_rep.l = long_rep{ buffer, count, encode_capacity(count) };
+	}
+
+	union rep
+	{
+		CharT s[local_length];
+		long_rep l;
+	};
+
+	// Members of the class
+	rep m_rep;
+	[[no_unique_address]] allocator_type m_alloc;
+
+};
+
+
+
+// Concatenation
+//
+// a + b + c + "x" builds a string_concat expression that refers to its operands and only knows
+// the total length; converting it to basic_string (or appending it) allocates once and copies
+// every piece once. The expression must be converted while its operands are alive, so keep the
+// result as a basic_string rather than auto. An rvalue string on the left is appended to instead.
+
+// one operand: a run of characters elsewhere, or a single character held by value
+template< class String >
+struct concat_chars
+{
+	const typename String::value_type* chars;
+	typename String::size_type count;
+
+	typename String::size_type size() const noexcept { return count; }
+	typename String::value_type* write( typename String::value_type* out ) const noexcept
+	{
+		String::traits_type::copy(out, chars, count);
+		return out + count;
+	}
+};
+
+template< class String >
+struct concat_char
+{
+	typename String::value_type ch;
+
+	typename String::size_type size() const noexcept { return 1; }
+	typename String::value_type* write( typename String::value_type* out ) const noexcept
+	{
+		String::traits_type::assign(*out, ch);
+		return out + 1;
+	}
+};
+
+template< class String, class Lhs, class Rhs >
+class string_concat
+{
+public:
+	using string_type = String;
+	using size_type = typename String::size_type;
+	using value_type = typename String::value_type;
+
+	string_concat( const Lhs& lhs, const Rhs& rhs ) noexcept : m_lhs(lhs), m_rhs(rhs), m_size(lhs.size() + rhs.size()) {}
+
+	size_type size() const noexcept { return m_size; }
+
+	// copies the characters to out and returns the end of what was written
+	value_type* write( value_type* out ) const noexcept { return m_rhs.write(m_lhs.write(out)); }
+
+private:
+	Lhs m_lhs;
+	Rhs m_rhs;
 	size_type m_size;
-	size_type m_capacity;
-	const CharT* m_data;
-	
 };
 
+template< class T >
+struct is_string_concat : std::false_type {};
+
+template< class String, class Lhs, class Rhs >
+struct is_string_concat<string_concat<String, Lhs, Rhs>> : std::true_type {};
+
+template< class String, class T >
+concept concat_operand = std::same_as<T, String>
+	|| std::same_as<T, basic_string_view<typename String::value_type, typename String::traits_type>>
+	|| std::same_as<T, typename String::value_type>
+	|| std::is_convertible_v<const T&, const typename String::value_type*>
+	|| (is_string_concat<T>::value && std::same_as<typename T::string_type, String>);
+
+template< class String, class T >
+auto concat_piece( const T& x ) noexcept
+{
+	using CharT = typename String::value_type;
+	if constexpr (std::same_as<T, String> || std::same_as<T, basic_string_view<CharT, typename String::traits_type>>)
+		return concat_chars<String>{ x.data(), x.size() };
+	else if constexpr (std::same_as<T, CharT>) return concat_char<String>{ x };
+	else if constexpr (is_string_concat<T>::value) return x;
+	else
+	{
+		const CharT* s = x;
+		return concat_chars<String>{ s, String::traits_type::length(s) };
+	}
+}
+
+template< class String, class Lhs, class Rhs >
+auto make_concat( const Lhs& lhs, const Rhs& rhs ) noexcept
+{
+	auto left = concat_piece<String>(lhs);
+	auto right = concat_piece<String>(rhs);
+	return string_concat<String, decltype(left), decltype(right)>(left, right);
+}
+
+template< class CharT, class Traits, class Allocator, class Rhs >
+	requires concat_operand<basic_string<CharT, Traits, Allocator>, Rhs>
+auto operator+( const basic_string<CharT, Traits, Allocator>& lhs, const Rhs& rhs ) noexcept
+{
+	return make_concat<basic_string<CharT, Traits, Allocator>>(lhs, rhs);
+}
+
+template< class Lhs, class CharT, class Traits, class Allocator >
+	requires concat_operand<basic_string<CharT, Traits, Allocator>, Lhs>
+		&& (!std::same_as<Lhs, basic_string<CharT, Traits, Allocator>>) && (!is_string_concat<Lhs>::value)
+auto operator+( const Lhs& lhs, const basic_string<CharT, Traits, Allocator>& rhs ) noexcept
+{
+	return make_concat<basic_string<CharT, Traits, Allocator>>(lhs, rhs);
+}
+
+template< class String, class L, class R, class Rhs >
+	requires concat_operand<String, Rhs>
+auto operator+( const string_concat<String, L, R>& lhs, const Rhs& rhs ) noexcept
+{
+	return make_concat<String>(lhs, rhs);
+}
+
+template< class Lhs, class String, class L, class R >
+	requires concat_operand<String, Lhs> && (!std::same_as<Lhs, String>) && (!is_string_concat<Lhs>::value)
+auto operator+( const Lhs& lhs, const string_concat<String, L, R>& rhs ) noexcept
+{
+	return make_concat<String>(lhs, rhs);
+}
+
+template< class CharT, class Traits, class Allocator, class Rhs >
+	requires concat_operand<basic_string<CharT, Traits, Allocator>, Rhs>
+basic_string<CharT, Traits, Allocator> operator+( basic_string<CharT, Traits, Allocator>&& lhs, const Rhs& rhs )
+{
+	if constexpr (std::same_as<Rhs, CharT> || !std::is_convertible_v<const Rhs&, const CharT*>) lhs += rhs;
+	else lhs.append(static_cast<const CharT*>(rhs));
+	return std::move(lhs);
+}
+
 
 
 using string = basic_string<char>;
@@ -0,0 +1,235 @@
+#ifndef STRING_HASH_H
+#define STRING_HASH_H
+
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <compare>
+#include <functional>
+#include <type_traits>
+
+#include "string.hpp"
+
+template< class CharT, class Traits, class Allocator >
+class basic_hashed_string;
+
+template< class T >
+concept hashable_char = std::same_as<T, char> || std::same_as<T, wchar_t> || std::same_as<T, char8_t>
+	|| std::same_as<T, char16_t> || std::same_as<T, char32_t>;
+
+// wyhash-style hash of the characters' bytes. Up to 16 bytes take two overlapping loads and a
+// single 64x64->128 multiply; longer input is folded 16 bytes at a time, and above 48 bytes in
+// three independent lanes so the multiplies overlap. Values are not portable across byte orders.
+//
+// Transparent: strings, views, hashed strings and const CharT* hash alike, so containers keyed
+// by basic_string can be searched with any of them.
+struct string_hasher
+{
+	using is_transparent = void;
+
+	std::uint64_t seed = 0;
+
+	template< class CharT, class Traits >
+	std::size_t operator()( basic_string_view<CharT, Traits> v ) const noexcept
+	{
+		return static_cast<std::size_t>(hash_bytes(v.data(), v.size() * sizeof(CharT), seed));
+	}
+
+	template< class CharT, class Traits, class Allocator >
+	std::size_t operator()( const basic_string<CharT, Traits, Allocator>& s ) const noexcept
+	{
+		return (*this)(basic_string_view<CharT, Traits>(s));
+	}
+
+	template< hashable_char CharT >
+	std::size_t operator()( const CharT* s ) const noexcept
+	{
+		return (*this)(basic_string_view<CharT>(s));
+	}
+
+	// the cached value was computed unseeded
+	template< class CharT, class Traits, class Allocator >
+	std::size_t operator()( const basic_hashed_string<CharT, Traits, Allocator>& s ) const noexcept
+	{
+		return seed == 0 ? s.hash() : (*this)(s.view());
+	}
+
+	static std::uint64_t hash_bytes( const void* data, std::size_t len, std::uint64_t seed = 0 ) noexcept
+	{
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		seed ^= mix(seed ^ secret[0], secret[1]);
+
+		std::uint64_t a, b;
+		if (len <= 16)
+		{
+			if (len >= 4)
+			{
+				const std::size_t mid = (len >> 3) << 2;
+				a = (read4(p) << 32) | read4(p + mid);
+				b = (read4(p + len - 4) << 32) | read4(p + len - 4 - mid);
+			}
+			else if (len > 0)
+			{
+				a = (std::uint64_t(p[0]) << 16) | (std::uint64_t(p[len >> 1]) << 8) | p[len - 1];
+				b = 0;
+			}
+			else a = b = 0;
+		}
+		else
+		{
+			std::size_t i = len;
+			if (i > 48)
+			{
+				std::uint64_t lane1 = seed, lane2 = seed;
+				do
+				{
+					seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+					lane1 = mix(read8(p + 16) ^ secret[2], read8(p + 24) ^ lane1);
+					lane2 = mix(read8(p + 32) ^ secret[3], read8(p + 40) ^ lane2);
+					p += 48;
+					i -= 48;
+				} while (i > 48);
+				seed ^= lane1 ^ lane2;
+			}
+			for (; i > 16; i -= 16, p += 16) seed = mix(read8(p) ^ secret[1], read8(p + 8) ^ seed);
+
+			// the last 16 bytes, overlapping what was already folded in
+			a = read8(p + i - 16);
+			b = read8(p + i - 8);
+		}
+
+		a ^= secret[1];
+		b ^= seed;
+		multiply(a, b);
+		return mix(a ^ secret[0] ^ len, b ^ secret[1]);
+	}
+
+private:
+	static constexpr std::uint64_t secret[4] = {
+		0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull, 0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+	};
+
+	static std::uint64_t read8( const unsigned char* p ) noexcept
+	{
+		std::uint64_t v;
+		std::memcpy(&v, p, 8);
+		return v;
+	}
+
+	static std::uint64_t read4( const unsigned char* p ) noexcept
+	{
+		std::uint32_t v;
+		std::memcpy(&v, p, 4);
+		return v;
+	}
+
+	// a, b = low and high half of a * b
+	static void multiply( std::uint64_t& a, std::uint64_t& b ) noexcept
+	{
+#ifdef __SIZEOF_INT128__
+		const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+		a = static_cast<std::uint64_t>(r);
+		b = static_cast<std::uint64_t>(r >> 64);
+#else
+		const std::uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<std::uint32_t>(a), lb = static_cast<std::uint32_t>(b);
+		const std::uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+		const std::uint64_t t = rl + (rm0 << 32);
+		const std::uint64_t lo = t + (rm1 << 32);
+		a = lo;
+		b = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+#endif
+	}
+
+	static std::uint64_t mix( std::uint64_t a, std::uint64_t b ) noexcept
+	{
+		multiply(a, b);
+		return a ^ b;
+	}
+};
+
+// An immutable string that hashes itself once, for keys that are hashed again and again
+// (rehashing, repeated lookups, several tables). basic_string has no room for the value:
+// its three words all belong to the small-string layout.
+template <
+    class CharT,
+    class Traits = std::char_traits<CharT>,
+    class Allocator = std::allocator<CharT>
+> class basic_hashed_string
+{
+public:
+	// Member types
+	using string_type = basic_string<CharT, Traits, Allocator>;
+	using view_type = basic_string_view<CharT, Traits>;
+	using value_type = CharT;
+	using size_type = typename string_type::size_type;
+	using const_iterator = typename string_type::const_iterator;
+
+	// Member functions
+	basic_hashed_string() : m_hash(string_hasher{}(m_str)) {}
+	explicit basic_hashed_string( string_type str ) : m_str(std::move(str)), m_hash(string_hasher{}(m_str)) {}
+	explicit basic_hashed_string( view_type v, const Allocator& alloc = Allocator() ) : basic_hashed_string(string_type(v, alloc)) {}
+	explicit basic_hashed_string( const CharT* s, const Allocator& alloc = Allocator() ) : basic_hashed_string(string_type(s, alloc)) {}
+
+	const string_type& str() const noexcept { return m_str; }
+	view_type view() const noexcept { return m_str; }
+	operator view_type() const noexcept { return m_str; }
+
+	std::size_t hash() const noexcept { return m_hash; }
+
+	const CharT* data() const noexcept { return m_str.data(); }
+	const CharT* c_str() const noexcept { return m_str.c_str(); }
+	size_type size() const noexcept { return m_str.size(); }
+	bool empty() const noexcept { return m_str.empty(); }
+	const_iterator begin() const noexcept { return m_str.begin(); }
+	const_iterator end() const noexcept { return m_str.end(); }
+
+	// different hashes settle most unequal pairs without touching the characters
+	friend bool operator==( const basic_hashed_string& lhs, const basic_hashed_string& rhs ) noexcept
+	{
+		return lhs.m_hash == rhs.m_hash && lhs.m_str == rhs.m_str;
+	}
+	friend bool operator==( const basic_hashed_string& lhs, view_type rhs ) noexcept { return lhs.view() == rhs; }
+	friend auto operator<=>( const basic_hashed_string& lhs, const basic_hashed_string& rhs ) noexcept { return lhs.m_str <=> rhs.m_str; }
+	friend auto operator<=>( const basic_hashed_string& lhs, view_type rhs ) noexcept { return lhs.view() <=> rhs; }
+
+private:
+	// Members of the class
+	string_type m_str;
+	std::size_t m_hash;
+};
+
+
+
+using hashed_string = basic_hashed_string<char>;
+using hashed_wstring = basic_hashed_string<wchar_t>;
+using hashed_u8string = basic_hashed_string<char8_t>;
+using hashed_u16string = basic_hashed_string<char16_t>;
+using hashed_u32string = basic_hashed_string<char32_t>;
+
+
+
+namespace std
+{
+	template< class CharT, class Traits, class Allocator >
+	struct hash<::basic_string<CharT, Traits, Allocator>>
+	{
+		std::size_t operator()( const ::basic_string<CharT, Traits, Allocator>& s ) const noexcept { return string_hasher{}(s); }
+	};
+
+	template< class CharT, class Traits >
+	struct hash<::basic_string_view<CharT, Traits>>
+	{
+		std::size_t operator()( ::basic_string_view<CharT, Traits> v ) const noexcept { return string_hasher{}(v); }
+	};
+
+	template< class CharT, class Traits, class Allocator >
+	struct hash<::basic_hashed_string<CharT, Traits, Allocator>>
+	{
+		std::size_t operator()( const ::basic_hashed_string<CharT, Traits, Allocator>& s ) const noexcept { return s.hash(); }
+	};
+}
+
+
+
+#endif //!STRING_HASH_H
@@ -0,0 +1,464 @@
+#ifndef STRING_SEARCH_H
+#define STRING_SEARCH_H
+
+
+#include <bit>
+#include <string>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__GNUC__) && defined(__SSE2__)
+#define STRING_SEARCH_X86 1
+#include <immintrin.h>
+#endif
+
+// Byte search kernels. On x86 the SSE2 versions are the baseline and AVX2 versions, compiled
+// alongside, are picked at run time when the CPU has AVX2 (unless STRING_SEARCH_NO_AVX2 is
+// defined, which keeps the SSE2 path for testing it); other targets use the scalar loops.
+//
+// Substrings are found by comparing the needle's first and last byte against a block of
+// candidate positions at once and checking the middle only where both match. Character sets
+// are looked up with two 16-entry tables indexed by the low nibble (AVX2), by comparing
+// against every member (SSE2, small sets) or in a 256-bit bitmap.
+struct byte_search
+{
+	static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+	// first position at which the m >= 1 bytes of s occur in h[0, n)
+	static std::size_t find( const unsigned char* h, std::size_t n, const unsigned char* s, std::size_t m ) noexcept
+	{
+		if (m > n) return npos;
+#ifdef STRING_SEARCH_X86
+		if (has_avx2()) return find_avx2(h, n, s, m);
+		return find_sse2(h, n, s, m);
+#else
+		return find_scalar(h, n, s, m);
+#endif
+	}
+
+	// last such position
+	static std::size_t rfind( const unsigned char* h, std::size_t n, const unsigned char* s, std::size_t m ) noexcept
+	{
+		if (m > n) return npos;
+#ifdef STRING_SEARCH_X86
+		if (has_avx2()) return rfind_avx2(h, n, s, m);
+		return rfind_sse2(h, n, s, m);
+#else
+		return rfind_scalar(h, n, s, m);
+#endif
+	}
+
+	// first position whose byte is (member) or is not (!member) one of the m bytes of set
+	static std::size_t find_of( const unsigned char* h, std::size_t n, const unsigned char* set, std::size_t m, bool member ) noexcept
+	{
+#ifdef STRING_SEARCH_X86
+		if (has_avx2()) return find_of_avx2(h, n, set, m, member);
+		return find_of_sse2(h, n, set, m, member);
+#else
+		return find_of_scalar(h, n, byte_set(set, m), member);
+#endif
+	}
+
+	// last such position
+	static std::size_t rfind_of( const unsigned char* h, std::size_t n, const unsigned char* set, std::size_t m, bool member ) noexcept
+	{
+#ifdef STRING_SEARCH_X86
+		if (has_avx2()) return rfind_of_avx2(h, n, set, m, member);
+		return rfind_of_sse2(h, n, set, m, member);
+#else
+		return rfind_of_scalar(h, n, byte_set(set, m), member);
+#endif
+	}
+
+private:
+	struct byte_set
+	{
+		std::uint64_t bits[4] = {};
+
+		byte_set( const unsigned char* set, std::size_t m ) noexcept
+		{
+			for (std::size_t i = 0; i < m; ++i) bits[set[i] >> 6] |= std::uint64_t(1) << (set[i] & 63);
+		}
+
+		bool contains( unsigned char c ) const noexcept { return (bits[c >> 6] >> (c & 63)) & 1; }
+	};
+
+	// Scalar loops, also used for the tails of the vector kernels
+
+	static std::size_t find_scalar( const unsigned char* h, std::size_t n, const unsigned char* s, std::size_t m ) noexcept
+	{
+		if (m > n) return npos;
+
+		std::size_t i = 0;
+		while (i + m <= n)
+		{
+			const void* hit = std::memchr(h + i, s[0], n - m + 1 - i);
+			if (hit == nullptr) return npos;
+
+			i = static_cast<std::size_t>(static_cast<const unsigned char*>(hit) - h);
+			if (std::memcmp(h + i + 1, s + 1, m - 1) == 0) return i;
+			++i;
+		}
+		return npos;
+	}
+
+	static std::size_t rfind_scalar( const unsigned char* h, std::size_t n, const unsigned char* s, std::size_t m ) noexcept
+	{
+		if (m > n) return npos;
+
+		for (std::size_t i = n - m + 1; i-- > 0;)
+			if (h[i] == s[0] && std::memcmp(h + i + 1, s + 1, m - 1) == 0) return i;
+		return npos;
+	}
+
+	static std::size_t find_of_scalar( const unsigned char* h, std::size_t n, const byte_set& set, bool member ) noexcept
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			if (set.contains(h[i]) == member) return i;
+		return npos;
+	}
+
+	static std::size_t rfind_of_scalar( const unsigned char* h, std::size_t n, const byte_set& set, bool member ) noexcept
+	{
+		for (std::size_t i = n; i-- > 0;)
+			if (set.contains(h[i]) == member) return i;
+		return npos;
+	}
+
+#ifdef STRING_SEARCH_X86
+	static bool has_avx2() noexcept
+	{
+#ifdef STRING_SEARCH_NO_AVX2
+		return false;
+#else
+		static const bool supported = [] {
+			__builtin_cpu_init();
+			return __builtin_cpu_supports("avx2") != 0;
+		}();
+		return supported;
+#endif
+	}
+
+	// positions whose first and last needle bytes both match are verified with memcmp;
+	// for m <= 2 those two bytes are the whole needle
+	static bool middle_matches( const unsigned char* at, const unsigned char* s, std::size_t m ) noexcept
+	{
+		return m <= 2 || std::memcmp(at + 1, s + 1, m - 2) == 0;
+	}
+
+	static std::size_t find_sse2( const unsigned char* h, std::size_t n, const unsigned char* s, std::size_t m ) noexcept
+	{
+		const __m128i first = _mm_set1_epi8(static_cast<char>(s[0]));
+		const __m128i last = _mm_set1_epi8(static_cast<char>(s[m - 1]));
+
+		std::size_t i = 0;
+		for (; i + m + 15 <= n; i += 16)
+		{
+			const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i));
+			const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i + m - 1));
+			unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+			for (; mask != 0; mask &= mask - 1)
+			{
+				const std::size_t at = i + std::countr_zero(mask);
+				if (middle_matches(h + at, s, m)) return at;
+			}
+		}
+
+		const std::size_t rest = find_scalar(h + i, n - i, s, m);
+		return rest == npos ? npos : i + rest;
+	}
+
+	__attribute__((target("avx2")))
+	static std::size_t find_avx2( const unsigned char* h, std::size_t n, const unsigned char* s, std::size_t m ) noexcept
+	{
+		const __m256i first = _mm256_set1_epi8(static_cast<char>(s[0]));
+		const __m256i last = _mm256_set1_epi8(static_cast<char>(s[m - 1]));
+
+		std::size_t i = 0;
+		for (; i + m + 31 <= n; i += 32)
+		{
+			const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i));
+			const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i + m - 1));
+			unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+			for (; mask != 0; mask &= mask - 1)
+			{
+				const std::size_t at = i + std::countr_zero(mask);
+				if (middle_matches(h + at, s, m)) return at;
+			}
+		}
+
+		const std::size_t rest = find_scalar(h + i, n - i, s, m);
+		return rest == npos ? npos : i + rest;
+	}
+
+	// candidate starts are [0, end); blocks are taken from the back
+	static std::size_t rfind_sse2( const unsigned char* h, std::size_t n, const unsigned char* s, std::size_t m ) noexcept
+	{
+		const __m128i first = _mm_set1_epi8(static_cast<char>(s[0]));
+		const __m128i last = _mm_set1_epi8(static_cast<char>(s[m - 1]));
+
+		std::size_t end = n - m + 1;
+		for (; end >= 16; end -= 16)
+		{
+			const std::size_t j = end - 16;
+			const __m128i block_first = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + j));
+			const __m128i block_last = _mm_loadu_si128(reinterpret_cast<const __m128i*>(h + j + m - 1));
+			unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, block_first), _mm_cmpeq_epi8(last, block_last))));
+			while (mask != 0)
+			{
+				const unsigned bit = 31 - std::countl_zero(mask);
+				if (middle_matches(h + j + bit, s, m)) return j + bit;
+				mask &= ~(1u << bit);
+			}
+		}
+
+		return rfind_scalar(h, end + m - 1, s, m);
+	}
+
+	__attribute__((target("avx2")))
+	static std::size_t rfind_avx2( const unsigned char* h, std::size_t n, const unsigned char* s, std::size_t m ) noexcept
+	{
+		const __m256i first = _mm256_set1_epi8(static_cast<char>(s[0]));
+		const __m256i last = _mm256_set1_epi8(static_cast<char>(s[m - 1]));
+
+		std::size_t end = n - m + 1;
+		for (; end >= 32; end -= 32)
+		{
+			const std::size_t j = end - 32;
+			const __m256i block_first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + j));
+			const __m256i block_last = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + j + m - 1));
+			unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, block_first), _mm256_cmpeq_epi8(last, block_last))));
+			while (mask != 0)
+			{
+				const unsigned bit = 31 - std::countl_zero(mask);
+				if (middle_matches(h + j + bit, s, m)) return j + bit;
+				mask &= ~(1u << bit);
+			}
+		}
+
+		return rfind_scalar(h, end + m - 1, s, m);
+	}
+
+	// SSE2 has no byte shuffle, so sets are matched member by member while that stays cheap
+	static constexpr std::size_t sse2_set_limit = 16;
+
+	static unsigned set_mask_sse2( __m128i block, const __m128i* members, std::size_t m ) noexcept
+	{
+		__m128i hit = _mm_setzero_si128();
+		for (std::size_t k = 0; k < m; ++k) hit = _mm_or_si128(hit, _mm_cmpeq_epi8(block, members[k]));
+		return static_cast<unsigned>(_mm_movemask_epi8(hit));
+	}
+
+	static std::size_t find_of_sse2( const unsigned char* h, std::size_t n, const unsigned char* set, std::size_t m, bool member ) noexcept
+	{
+		const byte_set bits(set, m);
+		if (m > sse2_set_limit) return find_of_scalar(h, n, bits, member);
+
+		__m128i members[sse2_set_limit];
+		for (std::size_t k = 0; k < m; ++k) members[k] = _mm_set1_epi8(static_cast<char>(set[k]));
+		const unsigned flip = member ? 0u : 0xFFFFu;
+
+		std::size_t i = 0;
+		for (; i + 16 <= n; i += 16)
+		{
+			const unsigned mask = set_mask_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h + i)), members, m) ^ flip;
+			if (mask != 0) return i + std::countr_zero(mask);
+		}
+
+		const std::size_t rest = find_of_scalar(h + i, n - i, bits, member);
+		return rest == npos ? npos : i + rest;
+	}
+
+	static std::size_t rfind_of_sse2( const unsigned char* h, std::size_t n, const unsigned char* set, std::size_t m, bool member ) noexcept
+	{
+		const byte_set bits(set, m);
+		if (m > sse2_set_limit) return rfind_of_scalar(h, n, bits, member);
+
+		__m128i members[sse2_set_limit];
+		for (std::size_t k = 0; k < m; ++k) members[k] = _mm_set1_epi8(static_cast<char>(set[k]));
+		const unsigned flip = member ? 0u : 0xFFFFu;
+
+		std::size_t end = n;
+		for (; end >= 16; end -= 16)
+		{
+			const unsigned mask = set_mask_sse2(_mm_loadu_si128(reinterpret_cast<const __m128i*>(h + end - 16)), members, m) ^ flip;
+			if (mask != 0) return end - 16 + (31 - std::countl_zero(mask));
+		}
+
+		return rfind_of_scalar(h, end, bits, member);
+	}
+
+	// Row tables for the nibble lookup: bit (hi & 7) of row lo is set when byte hi * 16 + lo is
+	// in the set, in the low table for hi < 8 and in the high table otherwise
+	struct nibble_tables
+	{
+		alignas(16) unsigned char low[16] = {};
+		alignas(16) unsigned char high[16] = {};
+
+		nibble_tables( const unsigned char* set, std::size_t m ) noexcept
+		{
+			for (std::size_t i = 0; i < m; ++i)
+				(set[i] < 0x80 ? low : high)[set[i] & 0x0F] |= static_cast<unsigned char>(1u << ((set[i] >> 4) & 7));
+		}
+	};
+
+	__attribute__((target("avx2")))
+	static unsigned set_mask_avx2( __m256i block, __m256i low_rows, __m256i high_rows ) noexcept
+	{
+		const __m256i nibble = _mm256_set1_epi8(0x0F);
+		const __m256i bit_of = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+		                                        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+
+		const __m256i lo = _mm256_and_si256(block, nibble);
+		const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(block, 4), nibble);
+
+		// the top bit of each byte picks the table, as it does for hi >= 8
+		const __m256i row = _mm256_blendv_epi8(_mm256_shuffle_epi8(low_rows, lo), _mm256_shuffle_epi8(high_rows, lo), block);
+		const __m256i bit = _mm256_shuffle_epi8(bit_of, hi);
+		return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit)));
+	}
+
+	__attribute__((target("avx2")))
+	static std::size_t find_of_avx2( const unsigned char* h, std::size_t n, const unsigned char* set, std::size_t m, bool member ) noexcept
+	{
+		const nibble_tables tables(set, m);
+		const __m256i low_rows = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.low)));
+		const __m256i high_rows = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.high)));
+		const unsigned flip = member ? 0u : ~0u;
+
+		std::size_t i = 0;
+		for (; i + 32 <= n; i += 32)
+		{
+			const unsigned mask = set_mask_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + i)), low_rows, high_rows) ^ flip;
+			if (mask != 0) return i + std::countr_zero(mask);
+		}
+
+		const std::size_t rest = find_of_scalar(h + i, n - i, byte_set(set, m), member);
+		return rest == npos ? npos : i + rest;
+	}
+
+	__attribute__((target("avx2")))
+	static std::size_t rfind_of_avx2( const unsigned char* h, std::size_t n, const unsigned char* set, std::size_t m, bool member ) noexcept
+	{
+		const nibble_tables tables(set, m);
+		const __m256i low_rows = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.low)));
+		const __m256i high_rows = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(tables.high)));
+		const unsigned flip = member ? 0u : ~0u;
+
+		std::size_t end = n;
+		for (; end >= 32; end -= 32)
+		{
+			const unsigned mask = set_mask_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(h + end - 32)), low_rows, high_rows) ^ flip;
+			if (mask != 0) return end - 32 + (31 - std::countl_zero(mask));
+		}
+
+		return rfind_of_scalar(h, end, byte_set(set, m), member);
+	}
+#endif
+};
+
+
+// Position-based searches with std::basic_string semantics. Byte-sized characters compared by
+// the standard traits go through byte_search, all others through Traits one character at a time.
+template< class CharT, class Traits >
+struct string_search
+{
+	static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+	static std::size_t find( const CharT* h, std::size_t n, const CharT* s, std::size_t m, std::size_t pos ) noexcept
+	{
+		if (pos > n || m > n - pos) return npos;
+		if (m == 0) return pos;
+		return shifted(find_in(h + pos, n - pos, s, m), pos);
+	}
+
+	static std::size_t rfind( const CharT* h, std::size_t n, const CharT* s, std::size_t m, std::size_t pos ) noexcept
+	{
+		if (m > n) return npos;
+		const std::size_t last = std::min(pos, n - m);
+		if (m == 0) return last;
+		return rfind_in(h, last + m, s, m);
+	}
+
+	static std::size_t find_first_of( const CharT* h, std::size_t n, const CharT* s, std::size_t m, std::size_t pos ) noexcept
+	{
+		if (pos >= n || m == 0) return npos;
+		return shifted(find_of_in(h + pos, n - pos, s, m, true), pos);
+	}
+
+	static std::size_t find_last_of( const CharT* h, std::size_t n, const CharT* s, std::size_t m, std::size_t pos ) noexcept
+	{
+		if (n == 0 || m == 0) return npos;
+		return rfind_of_in(h, std::min(pos, n - 1) + 1, s, m, true);
+	}
+
+	static std::size_t find_first_not_of( const CharT* h, std::size_t n, const CharT* s, std::size_t m, std::size_t pos ) noexcept
+	{
+		if (pos >= n) return npos;
+		return shifted(find_of_in(h + pos, n - pos, s, m, false), pos);
+	}
+
+	static std::size_t find_last_not_of( const CharT* h, std::size_t n, const CharT* s, std::size_t m, std::size_t pos ) noexcept
+	{
+		if (n == 0) return npos;
+		return rfind_of_in(h, std::min(pos, n - 1) + 1, s, m, false);
+	}
+
+private:
+	static constexpr bool bytewise = sizeof(CharT) == 1 && std::is_same_v<Traits, std::char_traits<CharT>>;
+
+	static const unsigned char* bytes( const CharT* p ) noexcept { return reinterpret_cast<const unsigned char*>(p); }
+
+	static std::size_t shifted( std::size_t at, std::size_t pos ) noexcept { return at == npos ? npos : at + pos; }
+
+	static std::size_t find_in( const CharT* h, std::size_t n, const CharT* s, std::size_t m ) noexcept
+	{
+		if constexpr (bytewise) return byte_search::find(bytes(h), n, bytes(s), m);
+		else
+		{
+			for (std::size_t i = 0; i + m <= n; ++i)
+				if (Traits::eq(h[i], s[0]) && Traits::compare(h + i, s, m) == 0) return i;
+			return npos;
+		}
+	}
+
+	static std::size_t rfind_in( const CharT* h, std::size_t n, const CharT* s, std::size_t m ) noexcept
+	{
+		if constexpr (bytewise) return byte_search::rfind(bytes(h), n, bytes(s), m);
+		else
+		{
+			for (std::size_t i = n - m + 1; i-- > 0;)
+				if (Traits::eq(h[i], s[0]) && Traits::compare(h + i, s, m) == 0) return i;
+			return npos;
+		}
+	}
+
+	static std::size_t find_of_in( const CharT* h, std::size_t n, const CharT* s, std::size_t m, bool member ) noexcept
+	{
+		if constexpr (bytewise) return byte_search::find_of(bytes(h), n, bytes(s), m, member);
+		else
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				if ((Traits::find(s, m, h[i]) != nullptr) == member) return i;
+			return npos;
+		}
+	}
+
+	static std::size_t rfind_of_in( const CharT* h, std::size_t n, const CharT* s, std::size_t m, bool member ) noexcept
+	{
+		if constexpr (bytewise) return byte_search::rfind_of(bytes(h), n, bytes(s), m, member);
+		else
+		{
+			for (std::size_t i = n; i-- > 0;)
+				if ((Traits::find(s, m, h[i]) != nullptr) == member) return i;
+			return npos;
+		}
+	}
+};
+
+
+
+#endif //!STRING_SEARCH_H
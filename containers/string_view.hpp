@@ -0,0 +1,217 @@
+#ifndef BASIC_STRING_VIEW_H
+#define BASIC_STRING_VIEW_H
+
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <algorithm>
+#include <stdexcept>
+#include <type_traits>
+
+#include "string_search.hpp"
+
+// Three-way comparison result of Traits: its comparison_category if it names one
+template< class Traits >
+struct string_ordering
+{
+	using type = std::weak_ordering;
+};
+
+template< class Traits >
+	requires requires { typename Traits::comparison_category; }
+struct string_ordering<Traits>
+{
+	using type = typename Traits::comparison_category;
+};
+
+// A pointer and a length into characters owned elsewhere. Slicing (substr, remove_prefix,
+// remove_suffix) never copies; the characters must outlive the view.
+template <
+    class CharT,
+    class Traits = std::char_traits<CharT>
+> class basic_string_view
+{
+public:
+	// Member types
+	using traits_type = Traits;
+	using value_type = CharT;
+	using pointer = CharT*;
+	using const_pointer = const CharT*;
+	using reference = CharT&;
+	using const_reference = const CharT&;
+	using const_iterator = const CharT*;
+	using iterator = const_iterator;
+	using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+	using reverse_iterator = const_reverse_iterator;
+	using size_type = std::size_t;
+	using difference_type = std::ptrdiff_t;
+
+	static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+	using search = string_search<CharT, Traits>;
+
+public:
+	// Member functions
+	constexpr basic_string_view() noexcept = default;
+	constexpr basic_string_view( const basic_string_view& other ) noexcept = default;
+	constexpr basic_string_view( const CharT* s, size_type count ) noexcept : m_data(s), m_size(count) {}
+	constexpr basic_string_view( const CharT* s ) noexcept : m_data(s), m_size(Traits::length(s)) {}
+	basic_string_view( std::nullptr_t ) = delete;
+
+	template< std::contiguous_iterator It, std::sized_sentinel_for<It> End >
+		requires std::is_same_v<std::iter_value_t<It>, CharT> && (!std::is_convertible_v<End, size_type>)
+	constexpr basic_string_view( It first, End last ) : m_data(std::to_address(first)), m_size(static_cast<size_type>(last - first)) {}
+
+	constexpr basic_string_view& operator=( const basic_string_view& view ) noexcept = default;
+
+	// Iterators
+	constexpr const_iterator begin() const noexcept { return m_data; }
+	constexpr const_iterator cbegin() const noexcept { return m_data; }
+	constexpr const_iterator end() const noexcept { return m_data + m_size; }
+	constexpr const_iterator cend() const noexcept { return m_data + m_size; }
+	constexpr const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+	constexpr const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+	constexpr const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+	constexpr const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+	// Element access
+	constexpr const_reference operator[]( size_type pos ) const { return m_data[pos]; }
+	constexpr const_reference at( size_type pos ) const
+	{
+		if (pos >= m_size)
+		{
+			throw std::out_of_range("Index out of bounds");
+		}
+		return m_data[pos];
+	}
+	constexpr const_reference front() const { return m_data[0]; }
+	constexpr const_reference back() const { return m_data[m_size - 1]; }
+	constexpr const_pointer data() const noexcept { return m_data; }
+
+	// Capacity
+	constexpr size_type size() const noexcept { return m_size; }
+	constexpr size_type length() const noexcept { return m_size; }
+	constexpr size_type max_size() const noexcept { return npos / sizeof(CharT); }
+	constexpr bool empty() const noexcept { return m_size == 0; }
+
+	// Modifiers
+	constexpr void remove_prefix( size_type n ) { m_data += n; m_size -= n; }
+	constexpr void remove_suffix( size_type n ) { m_size -= n; }
+	constexpr void swap( basic_string_view& v ) noexcept
+	{
+		std::swap(m_data, v.m_data);
+		std::swap(m_size, v.m_size);
+	}
+
+	// Operations
+	constexpr size_type copy( CharT* dest, size_type count, size_type pos = 0 ) const
+	{
+		if (pos > m_size) throw std::out_of_range("Position out of bounds");
+		const size_type rcount = std::min(count, m_size - pos);
+		Traits::copy(dest, m_data + pos, rcount);
+		return rcount;
+	}
+
+	constexpr basic_string_view substr( size_type pos = 0, size_type count = npos ) const
+	{
+		if (pos > m_size) throw std::out_of_range("Position out of bounds");
+		return basic_string_view(m_data + pos, std::min(count, m_size - pos));
+	}
+
+	constexpr int compare( basic_string_view v ) const noexcept
+	{
+		const int r = Traits::compare(m_data, v.m_data, std::min(m_size, v.m_size));
+		if (r != 0) return r;
+		return m_size < v.m_size ? -1 : m_size > v.m_size ? 1 : 0;
+	}
+	constexpr int compare( size_type pos1, size_type count1, basic_string_view v ) const { return substr(pos1, count1).compare(v); }
+	constexpr int compare( size_type pos1, size_type count1, basic_string_view v, size_type pos2, size_type count2 ) const
+	{
+		return substr(pos1, count1).compare(v.substr(pos2, count2));
+	}
+	constexpr int compare( const CharT* s ) const { return compare(basic_string_view(s)); }
+	constexpr int compare( size_type pos1, size_type count1, const CharT* s ) const { return substr(pos1, count1).compare(basic_string_view(s)); }
+	constexpr int compare( size_type pos1, size_type count1, const CharT* s, size_type count2 ) const
+	{
+		return substr(pos1, count1).compare(basic_string_view(s, count2));
+	}
+
+	constexpr bool starts_with( basic_string_view v ) const noexcept
+	{
+		return m_size >= v.m_size && Traits::compare(m_data, v.m_data, v.m_size) == 0;
+	}
+	constexpr bool starts_with( CharT ch ) const noexcept { return !empty() && Traits::eq(front(), ch); }
+	constexpr bool starts_with( const CharT* s ) const { return starts_with(basic_string_view(s)); }
+
+	constexpr bool ends_with( basic_string_view v ) const noexcept
+	{
+		return m_size >= v.m_size && Traits::compare(m_data + m_size - v.m_size, v.m_data, v.m_size) == 0;
+	}
+	constexpr bool ends_with( CharT ch ) const noexcept { return !empty() && Traits::eq(back(), ch); }
+	constexpr bool ends_with( const CharT* s ) const { return ends_with(basic_string_view(s)); }
+
+	bool contains( basic_string_view v ) const noexcept { return find(v) != npos; }
+	bool contains( CharT ch ) const noexcept { return find(ch) != npos; }
+	bool contains( const CharT* s ) const { return find(s) != npos; }
+
+	// Search
+	size_type find( basic_string_view v, size_type pos = 0 ) const noexcept { return search::find(m_data, m_size, v.m_data, v.m_size, pos); }
+	size_type find( CharT ch, size_type pos = 0 ) const noexcept { return find(basic_string_view(&ch, 1), pos); }
+	size_type find( const CharT* s, size_type pos, size_type count ) const { return find(basic_string_view(s, count), pos); }
+	size_type find( const CharT* s, size_type pos = 0 ) const { return find(basic_string_view(s), pos); }
+
+	size_type rfind( basic_string_view v, size_type pos = npos ) const noexcept { return search::rfind(m_data, m_size, v.m_data, v.m_size, pos); }
+	size_type rfind( CharT ch, size_type pos = npos ) const noexcept { return rfind(basic_string_view(&ch, 1), pos); }
+	size_type rfind( const CharT* s, size_type pos, size_type count ) const { return rfind(basic_string_view(s, count), pos); }
+	size_type rfind( const CharT* s, size_type pos = npos ) const { return rfind(basic_string_view(s), pos); }
+
+	size_type find_first_of( basic_string_view v, size_type pos = 0 ) const noexcept { return search::find_first_of(m_data, m_size, v.m_data, v.m_size, pos); }
+	size_type find_first_of( CharT ch, size_type pos = 0 ) const noexcept { return find(ch, pos); }
+	size_type find_first_of( const CharT* s, size_type pos, size_type count ) const { return find_first_of(basic_string_view(s, count), pos); }
+	size_type find_first_of( const CharT* s, size_type pos = 0 ) const { return find_first_of(basic_string_view(s), pos); }
+
+	size_type find_last_of( basic_string_view v, size_type pos = npos ) const noexcept { return search::find_last_of(m_data, m_size, v.m_data, v.m_size, pos); }
+	size_type find_last_of( CharT ch, size_type pos = npos ) const noexcept { return rfind(ch, pos); }
+	size_type find_last_of( const CharT* s, size_type pos, size_type count ) const { return find_last_of(basic_string_view(s, count), pos); }
+	size_type find_last_of( const CharT* s, size_type pos = npos ) const { return find_last_of(basic_string_view(s), pos); }
+
+	size_type find_first_not_of( basic_string_view v, size_type pos = 0 ) const noexcept { return search::find_first_not_of(m_data, m_size, v.m_data, v.m_size, pos); }
+	size_type find_first_not_of( CharT ch, size_type pos = 0 ) const noexcept { return find_first_not_of(basic_string_view(&ch, 1), pos); }
+	size_type find_first_not_of( const CharT* s, size_type pos, size_type count ) const { return find_first_not_of(basic_string_view(s, count), pos); }
+	size_type find_first_not_of( const CharT* s, size_type pos = 0 ) const { return find_first_not_of(basic_string_view(s), pos); }
+
+	size_type find_last_not_of( basic_string_view v, size_type pos = npos ) const noexcept { return search::find_last_not_of(m_data, m_size, v.m_data, v.m_size, pos); }
+	size_type find_last_not_of( CharT ch, size_type pos = npos ) const noexcept { return find_last_not_of(basic_string_view(&ch, 1), pos); }
+	size_type find_last_not_of( const CharT* s, size_type pos, size_type count ) const { return find_last_not_of(basic_string_view(s, count), pos); }
+	size_type find_last_not_of( const CharT* s, size_type pos = npos ) const { return find_last_not_of(basic_string_view(s), pos); }
+
+	// Comparison, also between a view and anything that converts to one (basic_string, const CharT*)
+	friend constexpr bool operator==( basic_string_view lhs, basic_string_view rhs ) noexcept
+	{
+		return lhs.m_size == rhs.m_size && Traits::compare(lhs.m_data, rhs.m_data, lhs.m_size) == 0;
+	}
+
+	friend constexpr auto operator<=>( basic_string_view lhs, basic_string_view rhs ) noexcept
+	{
+		return static_cast<typename string_ordering<Traits>::type>(lhs.compare(rhs) <=> 0);
+	}
+
+private:
+	// Members of the class
+	const CharT* m_data = nullptr;
+	size_type m_size = 0;
+};
+
+
+
+using string_view = basic_string_view<char>;
+using wstring_view = basic_string_view<wchar_t>;
+using u8string_view = basic_string_view<char8_t>;
+using u16string_view = basic_string_view<char16_t>;
+using u32string_view = basic_string_view<char32_t>;
+
+
+
+#endif //!BASIC_STRING_VIEW_H
@@ -4,34 +4,44 @@
 // CXX20
 
 #include <memory>
+#include <cstring>
 #include <limits>
 #include <concepts>
 #include <iostream>
+#include <compare>
 #include <iterator>
+#include <ranges>
 #include <stdexcept>
 #include <algorithm>
 #include <type_traits>
 #include <initializer_list>
 
+#include "growth_policy.hpp"
+
+template< class T, std::size_t N, class Allocator, class GrowthPolicy >
+class small_vector;
+
 template <
-    class T, class Allocator = std::allocator<T>>
+    class T, class Allocator = std::allocator<T>, class GrowthPolicy = growth_2x>
 class vector
 {
 private:
+    template< bool IsConst >
     class random_access_iterator;
 
 public:
     // Type declaration
     using value_type               =    T;
     using allocator_type           =    Allocator;
+    using growth_policy            =    GrowthPolicy;
     using size_type                =    std::size_t;
     using difference_type          =    std::ptrdiff_t;
     using reference                =    value_type&;
     using const_reference          =    const value_type&;
     using pointer                  =    typename std::allocator_traits<Allocator>::pointer;
     using const_pointer            =    typename std::allocator_traits<Allocator>::const_pointer;
-    using iterator                 =    random_access_iterator;
-    using const_iterator           =    const random_access_iterator;
+    using iterator                 =    random_access_iterator<false>;
+    using const_iterator           =    random_access_iterator<true>;
     using reverse_iterator         =    std::reverse_iterator<iterator>;
     using const_reverse_iterator   =    std::reverse_iterator<const_iterator>;
 
@@ -65,6 +75,9 @@ public:
     template <std::input_iterator InputIt>
     constexpr void assign(InputIt first, InputIt last);
     constexpr void assign(std::initializer_list<T> ilist);
+    template <std::ranges::input_range R>
+        requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+    constexpr void assign_range(R&& rg);
 
     // Get allocator
     constexpr allocator_type get_allocator() const { return m_alloc; }
@@ -119,6 +132,9 @@ public:
     template< std::input_iterator InputIt >
     constexpr iterator insert( const_iterator pos, InputIt first, InputIt last );
     constexpr iterator insert( const_iterator pos, std::initializer_list<T> ilist );
+    template< std::ranges::input_range R >
+        requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+    constexpr iterator insert_range( const_iterator pos, R&& rg );
 
     template< class... Args >
     constexpr iterator emplace( const_iterator pos, Args&&... args );
@@ -129,6 +145,10 @@ public:
     constexpr void push_back( const T& value );
     constexpr void push_back( T&& value );
 
+    template< std::ranges::input_range R >
+        requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+    constexpr void append_range( R&& rg );
+
     template< class... Args >
     constexpr reference emplace_back( Args&&... args );
 
@@ -136,101 +156,128 @@ public:
 
     constexpr void resize( size_type count );
     constexpr void resize( size_type count, const value_type& value );
+    constexpr void resize_for_overwrite( size_type count );
 
     constexpr void swap( vector& other ) noexcept(
         std::allocator_traits<Allocator>::propagate_on_container_swap::value
             || std::allocator_traits<Allocator>::is_always_equal::value);
 
 private:
+    template< class, std::size_t, class, class > friend class small_vector;
+
+    // One template for both iterator kinds, so iterator converts to const_iterator
+    // and the pair is a std::contiguous_iterator with O(1) arithmetic.
+    template< bool IsConst >
     class random_access_iterator
     {
     public:
         using difference_type = std::ptrdiff_t;
         using iterator_category = std::random_access_iterator_tag;
         using iterator_concept = std::contiguous_iterator_tag;
-        using iterator_type = T*;
-        using pointer = T*;
-        using reference = T&;
         using value_type = T;
+        using element_type = std::conditional_t<IsConst, const T, T>;
+        using iterator_type = element_type*;
+        using pointer = element_type*;
+        using reference = element_type&;
+
+        constexpr random_access_iterator() noexcept : m_ptr(nullptr) {}
+        constexpr random_access_iterator(const random_access_iterator &other) noexcept = default;
+        constexpr random_access_iterator& operator=(const random_access_iterator &other) noexcept = default;
 
-        random_access_iterator(const random_access_iterator &other) : m_ptr(other.m_ptr) {}
+        template< bool OtherConst >
+            requires (IsConst && !OtherConst)
+        constexpr random_access_iterator(const random_access_iterator<OtherConst> &other) noexcept
+            : m_ptr(other.m_ptr) {}
 
-        reference operator*() const { return *m_ptr; }
-        pointer operator->() const { return m_ptr; }
+        constexpr reference operator*() const noexcept { return *m_ptr; }
+        constexpr pointer operator->() const noexcept { return m_ptr; }
+        constexpr reference operator[](difference_type n) const noexcept { return m_ptr[n]; }
 
-        random_access_iterator& operator++()
+        constexpr random_access_iterator& operator++() noexcept
         {
-            m_ptr++;
+            ++m_ptr;
             return *this;
         }
-        random_access_iterator operator++(int)
+        constexpr random_access_iterator operator++(int) noexcept
         {
             random_access_iterator temp = *this;
-            ++(*this);
+            ++m_ptr;
             return temp;
         }
-        random_access_iterator& operator--()
+        constexpr random_access_iterator& operator--() noexcept
         {
-            m_ptr--;
+            --m_ptr;
             return *this;
         }
-        random_access_iterator operator--(int)
+        constexpr random_access_iterator operator--(int) noexcept
         {
             random_access_iterator temp = *this;
-            --(*this);
+            --m_ptr;
             return temp;
         }
 
-        random_access_iterator& operator+=(difference_type n)
+        constexpr random_access_iterator& operator+=(difference_type n) noexcept
         {
-            difference_type m = n;
-            if (m >= 0)
-                while (m--)
-                    ++m_ptr;
-            else
-                while (m++)
-                    --m_ptr;
-
+            m_ptr += n;
             return *this;
         }
-        random_access_iterator operator+(difference_type n)
-        {
-            random_access_iterator temp = *this;
-            return temp += n;
-        }
-        random_access_iterator& operator-=(difference_type n) { return *this += -n; }
-        random_access_iterator operator-(difference_type n)
+        constexpr random_access_iterator& operator-=(difference_type n) noexcept
         {
-            random_access_iterator temp = *this;
-            return temp -= n;
+            m_ptr -= n;
+            return *this;
         }
 
-        difference_type operator-(const random_access_iterator &other) const { return m_ptr - other.m_ptr; }
+        friend constexpr random_access_iterator operator+(random_access_iterator it, difference_type n) noexcept { return it += n; }
+        friend constexpr random_access_iterator operator+(difference_type n, random_access_iterator it) noexcept { return it += n; }
+        friend constexpr random_access_iterator operator-(random_access_iterator it, difference_type n) noexcept { return it -= n; }
 
-        reference operator[](difference_type n) { return *(this + n); }
+        friend constexpr difference_type operator-(const random_access_iterator &rhs, const random_access_iterator &lhs) noexcept { return rhs.m_ptr - lhs.m_ptr; }
 
-        friend bool operator==(const random_access_iterator &rhs, const random_access_iterator &lhs) { return rhs.m_ptr == lhs.m_ptr; }
-        friend bool operator!=(const random_access_iterator &rhs, const random_access_iterator &lhs) { return rhs.m_ptr != lhs.m_ptr; }
-        friend bool operator>=(const random_access_iterator &rhs, const random_access_iterator &lhs) { return rhs.m_ptr >= lhs.m_ptr; }
-        friend bool operator>(const random_access_iterator &rhs, const random_access_iterator &lhs) { return rhs.m_ptr > lhs.m_ptr; }
-        friend bool operator<=(const random_access_iterator &rhs, const random_access_iterator &lhs) { return rhs.m_ptr <= lhs.m_ptr; }
-        friend bool operator<(const random_access_iterator &rhs, const random_access_iterator &lhs) { return rhs.m_ptr < lhs.m_ptr; }
+        friend constexpr bool operator==(const random_access_iterator &rhs, const random_access_iterator &lhs) noexcept { return rhs.m_ptr == lhs.m_ptr; }
+        friend constexpr std::strong_ordering operator<=>(const random_access_iterator &rhs, const random_access_iterator &lhs) noexcept { return rhs.m_ptr <=> lhs.m_ptr; }
 
     private:
         friend class vector;
+        template< bool > friend class random_access_iterator;
+        template< class, std::size_t, class, class > friend class small_vector;
 
-        random_access_iterator() = default;
-        random_access_iterator(pointer ptr) : m_ptr(ptr) {}
+        constexpr explicit random_access_iterator(pointer ptr) noexcept : m_ptr(ptr) {}
 
         pointer m_ptr;
     };
 
-    void allocate_and_construct(size_type count, const T& value)
-    {
-        m_arr = std::allocator_traits<Allocator>::allocate(m_alloc, count);
-        for (std::size_t i = 0ul; i < count; i++)
-            std::allocator_traits<Allocator>::construct(m_alloc, m_arr + i, value);
-    }
+    // Growth engine: every path that reallocates or shifts elements goes through these.
+    // Trivially copyable types are relocated with memcpy/memmove, everything else with
+    // std::move_if_noexcept so a throwing copy leaves the old buffer untouched.
+    // Inside a buffer, elements whose move may throw are only moved by assignment, so every
+    // slot below m_size holds a live object whatever throws.
+    static constexpr bool is_trivially_relocatable = std::is_trivially_copyable_v<T>;
+    static constexpr bool is_nothrow_relocatable = is_trivially_relocatable || std::is_nothrow_move_constructible_v<T>;
+
+    static constexpr void move_into(Allocator& alloc, pointer first, pointer last, pointer dest);
+    static constexpr void construct_fill(Allocator& alloc, pointer dest, size_type count, const T& value);
+    static constexpr void construct_value(Allocator& alloc, pointer dest, size_type count);
+    static constexpr void construct_default(Allocator& alloc, pointer dest, size_type count);
+    template< std::input_iterator InputIt >
+    static constexpr void construct_copy(Allocator& alloc, InputIt first, size_type count, pointer dest);
+    static constexpr void destroy_range(Allocator& alloc, pointer first, pointer last) noexcept;
+
+    static constexpr void open_gap(Allocator& alloc, pointer first, pointer last, size_type count);
+    static constexpr void close_gap(Allocator& alloc, pointer first, pointer last, size_type count);
+    template< class Construct >
+    static constexpr void insert_in_place(Allocator& alloc, pointer arr, size_type& size,
+                                          size_type index, size_type count, Construct construct);
+    static constexpr void erase_in_place(Allocator& alloc, pointer arr, size_type& size,
+                                         size_type index, size_type count);
+    template< class Construct >
+    static constexpr void relocate_around(Allocator& alloc, pointer first, size_type size,
+                                          size_type index, size_type count, pointer dest, Construct construct);
+
+    constexpr void reallocate(size_type new_cap);
+    constexpr void deallocate_buffer(pointer arr, size_type cap) noexcept;
+    constexpr size_type recommend(size_type new_size) const;
+    template< class Construct >
+    constexpr iterator insert_with(size_type index, size_type count, Construct construct);
 
     pointer m_arr;
     size_type m_size;
@@ -238,76 +285,52 @@ private:
     Allocator m_alloc;
 };
 
-template< class T, class Allocator >
-constexpr vector<T, Allocator>::vector() noexcept(noexcept(Allocator()))
+template< class T, class Allocator, class GrowthPolicy >
+constexpr vector<T, Allocator, GrowthPolicy>::vector() noexcept(noexcept(Allocator()))
     : m_arr(nullptr), m_size(0ul), m_capacity(0ul), m_alloc() {}
 
-template< class T, class Allocator >
-constexpr vector<T, Allocator>::vector(const Allocator& alloc) noexcept
+template< class T, class Allocator, class GrowthPolicy >
+constexpr vector<T, Allocator, GrowthPolicy>::vector(const Allocator& alloc) noexcept
     : m_arr(nullptr), m_size(0ul), m_capacity(0ul), m_alloc(alloc) {}
 
-template< class T, class Allocator >
-constexpr vector<T, Allocator>::vector(size_type count, const T& value, const Allocator& alloc)
-    : m_arr(nullptr), m_size(count), m_capacity(count), m_alloc(alloc)
+template< class T, class Allocator, class GrowthPolicy >
+constexpr vector<T, Allocator, GrowthPolicy>::vector(size_type count, const T& value, const Allocator& alloc)
+    : vector(alloc)
 {
-    allocate_and_construct(count, value);
+    insert_with(0ul, count, [&](pointer dest) { construct_fill(m_alloc, dest, count, value); });
 }
 
-template< class T, class Allocator >
-constexpr vector<T, Allocator>::vector(size_type count, const Allocator& alloc)
-    : m_arr(nullptr), m_size(count), m_capacity(count), m_alloc(alloc)
+template< class T, class Allocator, class GrowthPolicy >
+constexpr vector<T, Allocator, GrowthPolicy>::vector(size_type count, const Allocator& alloc)
+    : vector(alloc)
 { 
-    allocate_and_construct(count, T()); 
+    resize(count);
 }
 
-
-template< class T, class Allocator >
+template< class T, class Allocator, class GrowthPolicy >
 template< std::input_iterator InputIt >
-constexpr vector<T, Allocator>::vector(InputIt first, InputIt last, const Allocator &alloc)
-    : m_arr(nullptr), 
-      m_size(std::distance(first, last)), 
-      m_capacity((std::distance(first, last))), 
-      m_alloc(alloc)
+constexpr vector<T, Allocator, GrowthPolicy>::vector(InputIt first, InputIt last, const Allocator &alloc)
+    : vector(alloc)
 {
-    m_arr = std::allocator_traits<Allocator>::allocate(m_alloc, m_capacity);
-    std::size_t counter = 0ul;
-    for (; first != last; ++first)
-    {
-        std::allocator_traits<Allocator>::construct(m_alloc, m_arr + counter, *first);
-        ++counter;
-    }
-        
+    append_range(std::ranges::subrange(first, last));
 }
 
-template< class T, class Allocator >
-constexpr vector<T, Allocator>::vector(const vector& other)
-    : m_arr(nullptr), 
-      m_size(other.m_capacity), 
-      m_capacity(other.m_capacity),
-      m_alloc(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator()))
+template< class T, class Allocator, class GrowthPolicy >
+constexpr vector<T, Allocator, GrowthPolicy>::vector(const vector& other)
+    : vector(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.get_allocator()))
 {
-    if (m_capacity > 0ul)
-    {
-        m_arr = std::allocator_traits<Allocator>::allocate(m_alloc, m_capacity);
-        for (std::size_t i = 0; i < m_size; i++)
-            std::allocator_traits<Allocator>::construct(m_alloc, m_arr + i, *(other.m_arr + i));
-    }
+    append_range(other);
 }
 
-template< class T, class Allocator >
-constexpr vector<T, Allocator>::vector(const vector& other, const Allocator& alloc)
-    : m_arr(other.m_arr), m_size(other.m_size), m_capacity(other.m_capacity), m_alloc(alloc) 
+template< class T, class Allocator, class GrowthPolicy >
+constexpr vector<T, Allocator, GrowthPolicy>::vector(const vector& other, const Allocator& alloc)
+    : vector(alloc)
 {
-    if (m_capacity > 0ul)
-    {
-        m_arr = std::allocator_traits<Allocator>::allocate(m_alloc, m_capacity);
-        for (std::size_t i = 0ul; i < m_size; i++)
-            std::allocator_traits<Allocator>::construct(m_alloc, m_arr + i, *(other.m_arr + i));
-    }
+    append_range(other);
 }
 
-template< class T, class Allocator >
-constexpr vector<T, Allocator>::vector(vector&& other) noexcept
+template< class T, class Allocator, class GrowthPolicy >
+constexpr vector<T, Allocator, GrowthPolicy>::vector(vector&& other) noexcept
     : m_arr(other.m_arr), m_size(other.m_size), m_capacity(other.m_capacity),
       m_alloc(std::move(other.get_allocator()))
 {
@@ -316,44 +339,50 @@ constexpr vector<T, Allocator>::vector(vector&& other) noexcept
     other.m_capacity = 0ul;
 }
 
-template< class T, class Allocator >
-constexpr vector<T, Allocator>::vector(vector&& other, const Allocator& alloc)
+template< class T, class Allocator, class GrowthPolicy >
+constexpr vector<T, Allocator, GrowthPolicy>::vector(vector&& other, const Allocator& alloc)
     : m_arr(other.m_arr), m_size(other.m_size), m_capacity(other.m_capacity),
       m_alloc(alloc)
 {
+    if (m_alloc != other.m_alloc)
+    {
+        // other's buffer belongs to a different allocator, only its elements can move
+        m_arr = nullptr;
+        m_size = 0ul;
+        m_capacity = 0ul;
+
+        append_range(std::ranges::subrange(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end())));
+        other.clear();
+        return;
+    }
+
     other.m_arr = nullptr;
     other.m_size = 0ul;
     other.m_capacity = 0ul;
 }
 
-template< class T, class Allocator >
-constexpr vector<T, Allocator>::vector(std::initializer_list<T> init, const Allocator& alloc) 
-    : m_size(init.size()), m_capacity(init.size()), m_alloc(alloc)
+template< class T, class Allocator, class GrowthPolicy >
+constexpr vector<T, Allocator, GrowthPolicy>::vector(std::initializer_list<T> init, const Allocator& alloc) 
+    : vector(alloc)
 {
-    m_arr = std::allocator_traits<Allocator>::allocate(m_alloc, m_capacity);
-    std::size_t counter = 0ul;
-    for (auto it = init.begin(); it != init.end(); ++it)
-    {
-        std::allocator_traits<Allocator>::construct(m_alloc, m_arr + counter, *it);
-        ++counter;
-    }   
+    append_range(init);
 }
 
-template< class T, class Allocator >
-constexpr vector<T, Allocator>::~vector()
+template< class T, class Allocator, class GrowthPolicy >
+constexpr vector<T, Allocator, GrowthPolicy>::~vector()
 {
     for (size_type i = 0ul; i < m_size; i++)
         std::allocator_traits<Allocator>::destroy(m_alloc, m_arr + i);
 
-    std::allocator_traits<Allocator>::deallocate(m_alloc, m_arr, m_capacity);
+    deallocate_buffer(m_arr, m_capacity);
     
     m_arr = nullptr;
     m_size = 0ul;
     m_capacity = 0ul;
 }
 
-template <class T, class Allocator>
-constexpr vector<T, Allocator>& vector<T, Allocator>::operator=(const vector& other)
+template <class T, class Allocator, class GrowthPolicy>
+constexpr vector<T, Allocator, GrowthPolicy>& vector<T, Allocator, GrowthPolicy>::operator=(const vector& other)
 {
     if (this != &other)
     {
@@ -364,7 +393,7 @@ constexpr vector<T, Allocator>& vector<T, Allocator>::operator=(const vector& ot
             {
                 for (std::size_t i = 0ul; i < m_size; ++i)
                     std::allocator_traits<allocator_type>::destroy(m_alloc, m_arr + i);
-                std::allocator_traits<allocator_type>::deallocate(m_alloc, m_arr, m_capacity);
+                deallocate_buffer(m_arr, m_capacity);
 
                 m_arr = nullptr;
                 m_size = 0ul;
@@ -374,32 +403,34 @@ constexpr vector<T, Allocator>& vector<T, Allocator>::operator=(const vector& ot
             }
         }
 
-        m_size = other.m_size;
-        m_capacity = other.m_capacity;
-
-        m_arr = std::allocator_traits<allocator_type>::allocate(m_alloc, m_capacity);
-        for (std::size_t i = 0ul; i < m_size; ++i)
-            std::allocator_traits<allocator_type>::construct(m_alloc, m_arr + i, *(other.m_arr + i));
-            
+        assign_range(other);
     }
 
     return *this;
-
 }
 
-template <class T, class Allocator>
-constexpr vector<T, Allocator>& vector<T, Allocator>::operator=(vector&& other) 
+template <class T, class Allocator, class GrowthPolicy>
+constexpr vector<T, Allocator, GrowthPolicy>& vector<T, Allocator, GrowthPolicy>::operator=(vector&& other) 
     noexcept(std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value == true)
 {
     if (this != &other)
     {
+        if constexpr (!std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value)
+        {
+            if (m_alloc != other.m_alloc)
+            {
+                assign_range(std::ranges::subrange(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end())));
+                other.clear();
+                return *this;
+            }
+        }
+
+        destroy_range(m_alloc, m_arr, m_arr + m_size);
+        deallocate_buffer(m_arr, m_capacity);
+
         if constexpr (std::allocator_traits<allocator_type>::propagate_on_container_move_assignment::value)
             m_alloc = other.get_allocator();
-        
-        for (std::size_t i = 0ul; i < m_size; ++i)
-            std::allocator_traits<allocator_type>::destroy(m_alloc, m_arr + i);
-        std::allocator_traits<allocator_type>::deallocate(m_alloc, m_arr, m_capacity);
-        
+
         m_size = other.m_size;
         m_capacity = other.m_capacity;
         m_arr = other.m_arr;
@@ -412,273 +443,594 @@ constexpr vector<T, Allocator>& vector<T, Allocator>::operator=(vector&& other)
     return *this;
 }
 
-template <class T, class Allocator>
-constexpr vector<T, Allocator>& vector<T, Allocator>::operator=(std::initializer_list<value_type> ilist)
+template <class T, class Allocator, class GrowthPolicy>
+constexpr vector<T, Allocator, GrowthPolicy>& vector<T, Allocator, GrowthPolicy>::operator=(std::initializer_list<value_type> ilist)
 {
-    for (std::size_t i = 0ul; i < m_size; ++i)
-        std::allocator_traits<allocator_type>::destroy(m_alloc, m_arr + i);
-    std::allocator_traits<allocator_type>::deallocate(m_alloc, m_arr, m_capacity);
-
-    m_size = ilist.size();
-    m_capacity = ilist.size();
-
-    m_arr = std::allocator_traits<allocator_type>::allocate(m_alloc, m_capacity);
-    size_type counter = 0ul;
-    for (auto it = ilist.begin(); it != ilist.end(); ++it)
-    {
-        std::allocator_traits<allocator_type>::construct(m_alloc, m_arr + counter, *it);
-        ++counter;
-    }
-
+    assign_range(ilist);
     return *this;
 }
 
-template <class T, class Allocator>
-constexpr void vector<T, Allocator>::assign( size_type count, const T& value )
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::assign( size_type count, const T& value )
 {
-    m_size = count; 
-    if (m_capacity >= count)
-    {
-        for (size_type i = 0; i < count; ++i)
-            m_arr[i] = value;
-    }
-    
-    else if (m_capacity < count)
-    {
-        reserve(count);
-        for (size_type i = 0; i < count; ++i)
-            m_arr[i] = value;
-    }
+    const value_type copy(value);
+    clear();
+    insert(cend(), count, copy);
 }
 
-template <class T, class Allocator>
+template <class T, class Allocator, class GrowthPolicy>
 template <std::input_iterator InputIt>
-constexpr void vector<T, Allocator>::assign(InputIt first, InputIt last)
+constexpr void vector<T, Allocator, GrowthPolicy>::assign(InputIt first, InputIt last)
 {
-    constexpr size_type count = std::distance(first, last);
+    assign_range(std::ranges::subrange(first, last));
+}
 
-    m_size = count;
-    size_type counter = 0;
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::assign(std::initializer_list<T> ilist)
+{
+    assign_range(ilist);
+}
 
-    if (m_capacity >= count)
-    {
-        for (; first != last; ++first)
-        {
-            m_arr[counter] = *first;
-            ++counter;
-        }
-    } 
+template <class T, class Allocator, class GrowthPolicy>
+template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+constexpr void vector<T, Allocator, GrowthPolicy>::assign_range(R&& rg)
+{
+    clear();
+    if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>)
+        reserve(static_cast<size_type>(std::ranges::distance(rg)));
 
-    else if (m_capacity < count)
-    {
-        reserve(count);
-        for (; first != last; ++first)
-        {
-            m_arr[counter] = *first;
-            ++counter;
-        }
-    }
+    append_range(std::forward<R>(rg));
 }
 
-template <class T, class Allocator>
-constexpr void vector<T, Allocator>::assign(std::initializer_list<T> ilist)
+template <class T, class Allocator, class GrowthPolicy>
+template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+constexpr void vector<T, Allocator, GrowthPolicy>::append_range(R&& rg)
 {
-    constexpr size_type count = std::distance(ilist.begin(), ilist.end());
+    insert_range(cend(), std::forward<R>(rg));
+}
 
-    m_size = count;
-    size_type counter = 0;
+template <class T, class Allocator, class GrowthPolicy>
+template <std::ranges::input_range R>
+    requires std::convertible_to<std::ranges::range_reference_t<R>, T>
+constexpr typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::insert_range(const_iterator pos, 
+    R&& rg)
+{
+    const size_type index = pos - cbegin();
 
-    if (m_capacity >= count)
+    // Sized and multi-pass ranges are measured once and copied in with a single allocation
+    if constexpr (std::ranges::forward_range<R> || std::ranges::sized_range<R>)
     {
-        for (auto it = ilist.begin(); it != ilist.end(); ++it)
-        {
-            m_arr[counter] = *it;
-            ++counter;
-        }
-    } 
+        const size_type count = static_cast<size_type>(std::ranges::distance(rg));
 
-    else if (m_capacity < count)
+        return insert_with(index, count,
+            [&](pointer dest) { construct_copy(m_alloc, std::ranges::begin(rg), count, dest); });
+    }
+    // Single-pass input is appended with geometric growth and rotated into place
+    else
     {
-        reserve(count);
-        for (auto it = ilist.begin(); it != ilist.end(); ++it)
+        const size_type old_size = m_size;
+        try
+        {
+            for (auto&& value : rg)
+                emplace_back(std::forward<decltype(value)>(value));
+        }
+        catch (...)
         {
-            m_arr[counter] = *it;
-            ++counter;
+            erase(cbegin() + old_size, cend());
+            throw;
         }
+
+        std::rotate(begin() + index, begin() + old_size, end());
+        return begin() + index;
     }
 }
 
-template <class T, class Allocator>
-constexpr typename vector<T, Allocator>::reference vector<T, Allocator>::at( size_type pos )
+template <class T, class Allocator, class GrowthPolicy>
+constexpr typename vector<T, Allocator, GrowthPolicy>::reference vector<T, Allocator, GrowthPolicy>::at( size_type pos )
 {
     if (pos >= size()) throw std::out_of_range("Index out of bounds");
     return *(m_arr + pos);
 }
 
-template <class T, class Allocator>
-constexpr typename vector<T, Allocator>::const_reference vector<T, Allocator>::at( size_type pos ) const
+template <class T, class Allocator, class GrowthPolicy>
+constexpr typename vector<T, Allocator, GrowthPolicy>::const_reference vector<T, Allocator, GrowthPolicy>::at( size_type pos ) const
 {
     if (pos >= size()) throw std::out_of_range("Index out of bounds");
     return *(m_arr + pos);
 }
 
-template <class T, class Allocator>
-constexpr void vector<T, Allocator>::reserve( size_type new_cap )
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::reserve( size_type new_cap )
 {
     if (new_cap > max_size()) throw std::length_error("New capacity is to much");
     if (new_cap <= m_capacity) return;
 
-    pointer new_arr = std::allocator_traits<allocator_type>::allocate(m_alloc, new_cap);
-    for (size_type i = 0ul; i < m_size; ++i)
-    {
-        std::allocator_traits<allocator_type>::construct(m_alloc, new_arr + i, *(m_arr + i));
+    reallocate(new_cap);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::shrink_to_fit()
+{
+    if (m_size == m_capacity) return;
+
+    reallocate(m_size);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::clear() noexcept
+{
+    for (size_type i = 0ul; i < m_size; i++)
         std::allocator_traits<allocator_type>::destroy(m_alloc, m_arr + i);
-    }
 
-    std::allocator_traits<allocator_type>::deallocate(m_alloc, m_arr, m_capacity);
+    m_size = 0ul;
+}
 
-    m_arr = new_arr;
-    m_capacity = new_cap;
+template <class T, class Allocator, class GrowthPolicy>
+constexpr typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::insert(const_iterator pos, const T& value)
+{
+    return emplace(pos, value);
+}
 
-    new_arr = nullptr;
+template <class T, class Allocator, class GrowthPolicy>
+constexpr typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::insert(const_iterator pos, T&& value)
+{
+    return emplace(pos, std::move(value));
 }
 
-template <class T, class Allocator>
-constexpr void vector<T, Allocator>::shrink_to_fit()
+template <class T, class Allocator, class GrowthPolicy>
+constexpr typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::insert(const_iterator pos,
+    size_type count, const T& value)
 {
-    if (m_size == m_capacity) return;
+    const size_type index = pos - cbegin();
+    const value_type copy(value);
 
-    pointer new_arr = std::allocator_traits<allocator_type>::allocate(m_alloc, m_size);
-    for (size_type i = 0ul; i < m_size; ++i)
+    return insert_with(index, count,
+        [&](pointer dest) { construct_fill(m_alloc, dest, count, copy); });
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+template <std::input_iterator InputIt>
+constexpr typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::insert(const_iterator pos, 
+    InputIt first, InputIt last)
+{
+    return insert_range(pos, std::ranges::subrange(first, last));
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+constexpr typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::insert(const_iterator pos,
+    std::initializer_list<T> ilist)
+{
+    return insert_range(pos, ilist);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+template <class... Args>
+constexpr typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::emplace(const_iterator pos, 
+    Args&& ...args)
+{
+    const size_type index = pos - cbegin();
+
+    // args may refer to an element that is about to be shifted
+    if (index != m_size && m_size < m_capacity)
     {
-        std::allocator_traits<allocator_type>::construct(m_alloc, new_arr + i, std::move(*(m_arr + i)));
-        std::allocator_traits<allocator_type>::destroy(m_alloc, m_arr + i);
+        value_type tmp(std::forward<Args>(args)...);
+        return insert_with(index, 1ul,
+            [&](pointer dest) { std::allocator_traits<allocator_type>::construct(m_alloc, dest, std::move(tmp)); });
     }
 
-    std::allocator_traits<allocator_type>::deallocate(m_alloc, m_arr, m_capacity);
+    return insert_with(index, 1ul,
+        [&](pointer dest) { std::allocator_traits<allocator_type>::construct(m_alloc, dest, std::forward<Args>(args)...); });
+}
 
-    m_arr = new_arr;
-    m_capacity = m_size;
+template <class T, class Allocator, class GrowthPolicy>
+constexpr typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::erase(const_iterator pos)
+{
+    const size_type index = pos - cbegin();
 
-    new_arr = nullptr;
+    erase_in_place(m_alloc, m_arr, m_size, index, 1ul);
+    return iterator(m_arr + index);
 }
 
-template <class T, class Allocator>
-constexpr void vector<T, Allocator>::clear() noexcept
+template <class T, class Allocator, class GrowthPolicy>
+constexpr typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::erase(const_iterator first, 
+    const_iterator last)
 {
-    for (size_type i = 0ul; i < m_size; i++)
-        std::allocator_traits<allocator_type>::destroy(m_alloc, m_arr + i);
+    const size_type index = first - cbegin();
+    const size_type count = last - first;
 
-    m_size = 0ul;
+    erase_in_place(m_alloc, m_arr, m_size, index, count);
+    return iterator(m_arr + index);
 }
 
-template <class T, class Allocator>
-constexpr typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(const_iterator pos, const T& value)
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::push_back(const T& value)
 {
-    const size_type index = pos - cbegin();
-    if (m_size >= m_capacity) reserve(2 * m_capacity);
+    emplace_back(value);
+}
 
-    for (size_type i = m_size; i > index; i--)
-        m_arr[i] = m_arr[i - 1];
-    
-    m_arr[index] = value;
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::push_back(T&& value)
+{
+    emplace_back(std::move(value));
+}
 
-    return iterator(m_arr + index);
+template <class T, class Allocator, class GrowthPolicy>
+template <class... Args>
+constexpr typename vector<T, Allocator, GrowthPolicy>::reference vector<T, Allocator, GrowthPolicy>::emplace_back(Args&& ...args)
+{
+    if (m_size < m_capacity)
+    {
+        std::allocator_traits<allocator_type>::construct(m_alloc, m_arr + m_size, std::forward<Args>(args)...);
+        return m_arr[m_size++];
+    }
+
+    return *insert_with(m_size, 1ul,
+        [&](pointer dest) { std::allocator_traits<allocator_type>::construct(m_alloc, dest, std::forward<Args>(args)...); });
 }
 
-template <class T, class Allocator>
-constexpr typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(const_iterator pos, T&& value)
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::pop_back()
 {
-    const size_type index = pos - cbegin();
-    if (m_size >= m_capacity) reserve(2 * m_capacity);
+    std::allocator_traits<allocator_type>::destroy(m_alloc, m_arr + --m_size);
+}
 
-    for (size_type i = m_size; i > index; i--)
-        m_arr[i] = m_arr[i - 1];
-    
-    m_arr[index] = std::move(value);
-    m_size++;
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::resize(size_type count)
+{
+    if (count < m_size)
+    {
+        destroy_range(m_alloc, m_arr + count, m_arr + m_size);
+        m_size = count;
+        return;
+    }
 
-    return iterator(m_arr + index);
+    const size_type extra = count - m_size;
+    insert_with(m_size, extra, [&](pointer dest) { construct_value(m_alloc, dest, extra); });
 }
 
-template <class T, class Allocator>
-constexpr typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(const_iterator pos,
-    size_type count, const T& value)
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::resize(size_type count, const value_type& value)
 {
-    const size_type index = pos - cbegin();
-    if (m_size >= m_capacity) reserve(2 * m_capacity);
+    if (count < m_size)
+    {
+        destroy_range(m_alloc, m_arr + count, m_arr + m_size);
+        m_size = count;
+        return;
+    }
 
-    for (size_type i = m_size; i > index; i--)
-        m_arr[i + count - 1] = m_arr[i - 1];
-    
-    for (size_type i = index; i < index + count; ++i)
-        m_arr[i] = value;
+    insert(cend(), count - m_size, value);
+}
 
-    m_size += count;
-    return iterator(m_arr + index);
+// Grows like resize() but default-initializes the new elements: for trivial types
+// the memory is left as the allocator returned it, ready to be filled through data().
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::resize_for_overwrite(size_type count)
+{
+    if (count < m_size)
+    {
+        destroy_range(m_alloc, m_arr + count, m_arr + m_size);
+        m_size = count;
+        return;
+    }
+
+    const size_type extra = count - m_size;
+    insert_with(m_size, extra, [&](pointer dest) { construct_default(m_alloc, dest, extra); });
 }
 
-template <class T, class Allocator>
+// Exchanges the buffers; allocators follow only when they propagate on swap, otherwise
+// they must compare equal, as for std::vector
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::swap(vector& other) noexcept(
+    std::allocator_traits<Allocator>::propagate_on_container_swap::value
+        || std::allocator_traits<Allocator>::is_always_equal::value)
+{
+    using std::swap;
+    swap(m_arr, other.m_arr);
+    swap(m_size, other.m_size);
+    swap(m_capacity, other.m_capacity);
+    if constexpr (std::allocator_traits<allocator_type>::propagate_on_container_swap::value)
+        swap(m_alloc, other.m_alloc);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::move_into(Allocator& alloc, pointer first, pointer last, pointer dest)
+{
+    if constexpr (is_trivially_relocatable)
+    {
+        if (first != last)
+            std::memcpy(std::to_address(dest), std::to_address(first), (last - first) * sizeof(T));
+    }
+    else
+    {
+        pointer current = dest;
+        try
+        {
+            for (; first != last; ++first, ++current)
+                std::allocator_traits<Allocator>::construct(alloc, current, std::move_if_noexcept(*first));
+        }
+        catch (...)
+        {
+            destroy_range(alloc, dest, current);
+            throw;
+        }
+    }
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::construct_fill(Allocator& alloc, pointer dest, size_type count, const T& value)
+{
+    size_type i = 0ul;
+    try
+    {
+        for (; i < count; ++i)
+            std::allocator_traits<Allocator>::construct(alloc, dest + i, value);
+    }
+    catch (...)
+    {
+        destroy_range(alloc, dest, dest + i);
+        throw;
+    }
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::construct_value(Allocator& alloc, pointer dest, size_type count)
+{
+    size_type i = 0ul;
+    try
+    {
+        for (; i < count; ++i)
+            std::allocator_traits<Allocator>::construct(alloc, dest + i);
+    }
+    catch (...)
+    {
+        destroy_range(alloc, dest, dest + i);
+        throw;
+    }
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::construct_default(Allocator& alloc, pointer dest, size_type count)
+{
+    if constexpr (std::is_trivially_default_constructible_v<T>) return;
+    else
+    {
+        size_type i = 0ul;
+        try
+        {
+            for (; i < count; ++i)
+                ::new (static_cast<void*>(std::to_address(dest + i))) T;
+        }
+        catch (...)
+        {
+            destroy_range(alloc, dest, dest + i);
+            throw;
+        }
+    }
+}
+
+template <class T, class Allocator, class GrowthPolicy>
 template <std::input_iterator InputIt>
-constexpr typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(const_iterator pos, 
-    InputIt first, InputIt last)
+constexpr void vector<T, Allocator, GrowthPolicy>::construct_copy(Allocator& alloc, InputIt first, size_type count, pointer dest)
 {
-    const size_type index = pos - cbegin();
-    if (m_size >= m_capacity) reserve(2 * m_capacity);
+    if constexpr (is_trivially_relocatable && std::contiguous_iterator<InputIt>
+                  && std::is_same_v<std::iter_value_t<InputIt>, T>)
+    {
+        if (count > 0ul)
+            std::memcpy(std::to_address(dest), std::to_address(first), count * sizeof(T));
+        return;
+    }
+
+    size_type i = 0ul;
+    try
+    {
+        for (; i < count; ++i, ++first)
+            std::allocator_traits<Allocator>::construct(alloc, dest + i, *first);
+    }
+    catch (...)
+    {
+        destroy_range(alloc, dest, dest + i);
+        throw;
+    }
+}
 
-    const difference_type count = std::distance(first, last);
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::destroy_range(Allocator& alloc, pointer first, pointer last) noexcept
+{
+    if constexpr (!std::is_trivially_destructible_v<T>)
+        for (; first != last; ++first)
+            std::allocator_traits<Allocator>::destroy(alloc, first);
+}
 
-    for (size_type i = m_size; i > index; i--)
-        m_arr[i + count - 1] = m_arr[i - 1];
+// Shifts [first, last) up or down by count slots, for elements that relocate without throwing
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::open_gap(Allocator& alloc, pointer first, pointer last, 
+    size_type count)
+{
+    if (first == last || count == 0ul) return;
 
-    for (size_type i = 0; i < count; ++i)
-        m_arr[index + i] = *first++;
-    
-    m_size += count;
-    return iterator(m_arr + index);    
+    if constexpr (is_trivially_relocatable)
+        std::memmove(std::to_address(first + count), std::to_address(first), (last - first) * sizeof(T));
+    else
+    {
+        while (last != first)
+        {
+            --last;
+            std::allocator_traits<Allocator>::construct(alloc, last + count, std::move(*last));
+            std::allocator_traits<Allocator>::destroy(alloc, last);
+        }
+    }
 }
 
-template <class T, class Allocator>
-constexpr typename vector<T, Allocator>::iterator vector<T, Allocator>::insert(const_iterator pos,
-    std::initializer_list<T> ilist)
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::close_gap(Allocator& alloc, pointer first, pointer last, 
+    size_type count)
 {
-    const size_type index = pos - cbegin();
-    if (m_size >= m_capacity) reserve(2 * m_capacity);
+    if (first == last || count == 0ul) return;
 
-    auto it = ilist.begin();
-    const difference_type count = std::distance(it, ilist.end());
+    if constexpr (is_trivially_relocatable)
+        std::memmove(std::to_address(first - count), std::to_address(first), (last - first) * sizeof(T));
+    else
+    {
+        for (; first != last; ++first)
+        {
+            std::allocator_traits<Allocator>::construct(alloc, first - count, std::move(*first));
+            std::allocator_traits<Allocator>::destroy(alloc, first);
+        }
+    }
+}
 
-    for (size_type i = m_size; i > index; i--)
-        m_arr[i + count - 1] = m_arr[i - 1];
+// Builds count new elements at arr + index in a buffer with room for them. When moving
+// may throw they are built past the end and rotated into place, as insert_range does
+// for single-pass input, so a throw midway still leaves [arr, arr + size) alive.
+template <class T, class Allocator, class GrowthPolicy>
+template <class Construct>
+constexpr void vector<T, Allocator, GrowthPolicy>::insert_in_place(Allocator& alloc, pointer arr, 
+    size_type& size, size_type index, size_type count, Construct construct)
+{
+    if constexpr (is_nothrow_relocatable)
+    {
+        open_gap(alloc, arr + index, arr + size, count);
+        try
+        {
+            construct(arr + index);
+        }
+        catch (...)
+        {
+            close_gap(alloc, arr + index + count, arr + size + count, count);
+            throw;
+        }
 
-    for (size_type i = 0; i < count; ++i)
-        m_arr[index + i] = *it++;
-    
-    m_size += count;
-    return iterator(m_arr + index);
+        size += count;
+    }
+    else
+    {
+        construct(arr + size);
+        size += count;
+        std::rotate(arr + index, arr + size - count, arr + size);
+    }
 }
 
-template <class T, class Allocator>
-template <class... Args>
-constexpr typename vector<T, Allocator>::iterator vector<T, Allocator>::emplace(const_iterator pos, 
-    Args&& ...args)
+// Removes [arr + index, arr + index + count) by move-assigning the tail over it, as
+// std::vector does; a throwing assignment leaves size and every element alive.
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::erase_in_place(Allocator& alloc, pointer arr, 
+    size_type& size, size_type index, size_type count)
 {
-    const size_type index = pos - cbegin();
-    if (m_size >= m_capacity) reserve(2 * m_capacity);
+    if (count == 0ul) return;
 
-    for (size_type i = m_size; i > index; i--)
-        m_arr[i] = m_arr[i - 1];
+    if constexpr (is_trivially_relocatable)
+        close_gap(alloc, arr + index + count, arr + size, count);
+    else
+    {
+        std::move(arr + index + count, arr + size, arr + index);
+        destroy_range(alloc, arr + size - count, arr + size);
+    }
 
-    std::allocator_traits<allocator_type>::construct(m_alloc, m_arr + index, std::forward<Args>(args)...);
-    
-    m_size++;
-    return (m_arr + index);
-    
+    size -= count;
 }
 
+// Builds count new elements at dest + index and moves [first, first + size) around them.
+// On failure dest holds no live objects and the source range is untouched.
+template <class T, class Allocator, class GrowthPolicy>
+template <class Construct>
+constexpr void vector<T, Allocator, GrowthPolicy>::relocate_around(Allocator& alloc, pointer first, 
+    size_type size, size_type index, size_type count, pointer dest, Construct construct)
+{
+    construct(dest + index);
+    try
+    {
+        move_into(alloc, first, first + index, dest);
+        try
+        {
+            move_into(alloc, first + index, first + size, dest + index + count);
+        }
+        catch (...)
+        {
+            destroy_range(alloc, dest, dest + index);
+            throw;
+        }
+    }
+    catch (...)
+    {
+        destroy_range(alloc, dest + index, dest + index + count);
+        throw;
+    }
+}
 
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::reallocate(size_type new_cap)
+{
+    pointer new_arr = new_cap > 0ul ? std::allocator_traits<allocator_type>::allocate(m_alloc, new_cap) : nullptr;
+    try
+    {
+        move_into(m_alloc, m_arr, m_arr + m_size, new_arr);
+    }
+    catch (...)
+    {
+        deallocate_buffer(new_arr, new_cap);
+        throw;
+    }
+
+    destroy_range(m_alloc, m_arr, m_arr + m_size);
+    deallocate_buffer(m_arr, m_capacity);
+
+    m_arr = new_arr;
+    m_capacity = new_cap;
+}
+
+// An empty vector has no buffer; allocators are not required to accept a null pointer
+template <class T, class Allocator, class GrowthPolicy>
+constexpr void vector<T, Allocator, GrowthPolicy>::deallocate_buffer(pointer arr, size_type cap) noexcept
+{
+    if (arr != nullptr) std::allocator_traits<allocator_type>::deallocate(m_alloc, arr, cap);
+}
+
+template <class T, class Allocator, class GrowthPolicy>
+constexpr typename vector<T, Allocator, GrowthPolicy>::size_type vector<T, Allocator, GrowthPolicy>::recommend(size_type new_size) const
+{
+    if (new_size > max_size()) throw std::length_error("New capacity is to much");
+
+    const size_type new_cap = GrowthPolicy::next_capacity(m_capacity, new_size, sizeof(T));
+    return std::max(new_size, std::min(new_cap, max_size()));
+}
 
+template <class T, class Allocator, class GrowthPolicy>
+template <class Construct>
+constexpr typename vector<T, Allocator, GrowthPolicy>::iterator vector<T, Allocator, GrowthPolicy>::insert_with(size_type index, 
+    size_type count, Construct construct)
+{
+    if (count == 0ul) return iterator(m_arr + index);
 
+    if (m_size + count <= m_capacity)
+    {
+        insert_in_place(m_alloc, m_arr, m_size, index, count, construct);
+        return iterator(m_arr + index);
+    }
+
+    // The new elements are built first, so arguments referring into the old buffer stay valid
+    const size_type new_cap = recommend(m_size + count);
+    pointer new_arr = std::allocator_traits<allocator_type>::allocate(m_alloc, new_cap);
+    try
+    {
+        relocate_around(m_alloc, m_arr, m_size, index, count, new_arr, construct);
+    }
+    catch (...)
+    {
+        deallocate_buffer(new_arr, new_cap);
+        throw;
+    }
+
+    destroy_range(m_alloc, m_arr, m_arr + m_size);
+    deallocate_buffer(m_arr, m_capacity);
+
+    m_arr = new_arr;
+    m_size += count;
+    m_capacity = new_cap;
+
+    return iterator(m_arr + index);
+}
 
 #endif //! OWN_VECTOR_H
 
@@ -0,0 +1,42 @@
+#include "../containers/allocators.hpp"
+
+#include <cassert>
+#include <vector>
+
+int main()
+{
+    {
+        // a zero initial size falls back to the default instead of never growing
+        monotonic_arena arena(0);
+        assert(arena.allocate(10) != nullptr);
+        assert(arena.allocate(5000) != nullptr);
+    }
+
+    {
+        // release() hands the caller's buffer out again
+        alignas(std::max_align_t) char buffer[256];
+        monotonic_arena arena(buffer, sizeof(buffer));
+
+        void* first = arena.allocate(64);
+        assert(first == buffer);
+        arena.allocate(1000);
+        arena.release();
+
+        assert(arena.allocate(64) == buffer);
+        arena.release();
+        assert(arena.allocate(300) != nullptr);
+    }
+
+    {
+        pool_resource pool;
+        pmr_adaptor<pool_resource> adaptor(pool);
+
+        void* empty = adaptor.allocate(0);
+        assert(empty != nullptr);
+        adaptor.deallocate(empty, 0);
+
+        std::vector<int, std::pmr::polymorphic_allocator<int>> v{ &adaptor };
+        for (int i = 0; i < 1000; ++i) v.push_back(i);
+        assert(v.size() == 1000 && v.back() == 999);
+    }
+}
@@ -0,0 +1,115 @@
+#include "../containers/btree_set.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <concepts>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+
+// Random inserts and erases against std::set. Small nodes make every erase path come up
+// often: borrowing from either sibling, merging, and the root shrinking a level.
+
+static std::mt19937 rng(16);
+
+static int random_key(int range) { return std::uniform_int_distribution<int>(0, range - 1)(rng); }
+
+// the string is long enough to live on the heap, so a key moved from twice or leaked shows up
+static std::string make_key(int i) { return std::string(20, 'k') + std::to_string(1000000 + i); }
+
+template< class Btree, class Std >
+static void check(const Btree& tree, const Std& expected)
+{
+    assert(tree.size() == expected.size());
+    assert(std::equal(tree.begin(), tree.end(), expected.begin(), expected.end()));
+
+    // and backwards, which climbs out of leaves the other way
+    auto it = tree.end();
+    for (auto e = expected.rbegin(); e != expected.rend(); ++e) assert(*--it == *e);
+    assert(it == tree.begin());
+}
+
+template< class Btree >
+static void run(int rounds, int range)
+{
+    using key_type = typename Btree::key_type;
+    auto key = [](int i) {
+        if constexpr (std::same_as<key_type, int>) return i;
+        else return make_key(i);
+    };
+
+    Btree tree;
+    std::set<key_type> expected;
+
+    for (int round = 0; round < rounds; ++round)
+    {
+        // grow to about range / 2 keys, then shrink back to empty, then grow again
+        const bool growing = (round / (range * 2)) % 2 == 0;
+        const key_type k = key(random_key(range));
+
+        if (growing == (random_key(4) != 0))
+        {
+            const auto [it, inserted] = tree.insert(k);
+            assert(inserted == expected.insert(k).second);
+            assert(*it == k);
+        }
+        else
+        {
+            auto it = tree.find(k);
+            auto e = expected.find(k);
+            assert((it == tree.end()) == (e == expected.end()));
+            if (e != expected.end())
+            {
+                it = tree.erase(it);
+                e = expected.erase(e);
+                assert((it == tree.end()) == (e == expected.end()));
+                if (e != expected.end()) assert(*it == *e);
+            }
+        }
+
+        if (round % 97 == 0) check(tree, expected);
+    }
+    check(tree, expected);
+
+    // drain from the front, the back and the middle
+    while (!expected.empty())
+    {
+        auto e = expected.begin();
+        switch (random_key(3))
+        {
+        case 0: break;
+        case 1: e = std::prev(expected.end()); break;
+        default: std::advance(e, expected.size() / 2); break;
+        }
+        auto it = tree.erase(tree.find(*e));
+        e = expected.erase(e);
+        assert((it == tree.end()) == (e == expected.end()));
+        if (e != expected.end()) assert(*it == *e);
+    }
+    check(tree, expected);
+    assert(tree.begin() == tree.end());
+
+    // copies are deep and independent
+    for (int i = 0; i < range; i += 3) { tree.insert(key(i)); expected.insert(key(i)); }
+    Btree copy = tree;
+    copy.erase(copy.begin());
+    check(tree, expected);
+    tree = copy;
+    expected.erase(expected.begin());
+    check(tree, expected);
+}
+
+int main()
+{
+    static_assert(btree_set<int, std::less<int>, std::allocator<int>, 16>::node_capacity == 3);
+    static_assert(btree_set<int, std::less<int>, std::allocator<int>, 32>::node_capacity == 4);
+    static_assert(btree_set<int, std::less<int>, std::allocator<int>, 36>::node_capacity == 5);
+
+    run<btree_set<int, std::less<int>, std::allocator<int>, 16>>(200000, 2000);
+    run<btree_set<int, std::less<int>, std::allocator<int>, 32>>(200000, 2000);
+    run<btree_set<int, std::less<int>, std::allocator<int>, 36>>(200000, 2000);
+    run<btree_set<int>>(400000, 20000);
+    run<btree_set<std::string, std::less<std::string>, std::allocator<std::string>, 0>>(100000, 1000);
+    run<btree_set<std::string>>(100000, 3000);
+}
@@ -0,0 +1,115 @@
+#include "../containers/flat_set.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <iterator>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+// Lookups of both layouts against std::set. For the Eytzinger layout every size up to a few
+// full levels is tried and every key and gap is probed, so each node of each tree shape has its
+// rank computed; random inserts and erases then keep the index rebuilt from odd shapes.
+
+template< class Compare >
+using eytzinger_set = flat_set<int, Compare, vector<int>, eytzinger_layout>;
+
+template< class Set, class Std >
+static void check_lookup(const Set& s, const Std& expected, int key)
+{
+    const auto lower = std::distance(expected.begin(), expected.lower_bound(key));
+    const auto upper = std::distance(expected.begin(), expected.upper_bound(key));
+
+    assert(s.lower_bound(key) - s.begin() == lower);
+    assert(s.upper_bound(key) - s.begin() == upper);
+    assert(s.contains(key) == expected.contains(key));
+    assert(s.count(key) == expected.count(key));
+    assert(s.find(key) == (expected.contains(key) ? s.begin() + lower : s.end()));
+}
+
+template< class Set, class Std >
+static void check(const Set& s, const Std& expected, int lo, int hi)
+{
+    assert(s.size() == expected.size());
+    assert(std::equal(s.begin(), s.end(), expected.begin(), expected.end()));
+    for (int key = lo; key <= hi; ++key) check_lookup(s, expected, key);
+}
+
+template< class Compare >
+static void every_shape()
+{
+    for (int n = 0; n <= 520; ++n)
+    {
+        // even keys, so each key and each gap between two of them is probed
+        std::set<int, Compare> expected;
+        for (int i = 0; i < n; ++i) expected.insert(2 * i);
+
+        const eytzinger_set<Compare> s(expected.begin(), expected.end());
+        const flat_set<int, Compare> sorted(expected.begin(), expected.end());
+        check(s, expected, -2, 2 * n);
+        check(sorted, expected, -2, 2 * n);
+    }
+}
+
+template< class Set >
+static void random_ops()
+{
+    std::mt19937 rng(17);
+    auto below = [&](int n) { return std::uniform_int_distribution<int>(0, n - 1)(rng); };
+
+    Set s;
+    std::set<int> expected;
+    for (int round = 0; round < 4000; ++round)
+    {
+        const int key = below(600);
+        switch (below(4))
+        {
+        case 0:
+            assert(s.insert(key).second == expected.insert(key).second);
+            break;
+        case 1:
+            if (s.contains(key)) s.erase(s.find(key));
+            expected.erase(key);
+            break;
+        case 2:
+        {
+            std::vector<int> keys;
+            for (int i = below(40); i > 0; --i) keys.push_back(below(600));
+            s.insert(keys.begin(), keys.end());
+            expected.insert(keys.begin(), keys.end());
+            break;
+        }
+        default:
+            check_lookup(s, expected, key);
+            break;
+        }
+        if (round % 200 == 0) check(s, expected, -1, 600);
+    }
+    check(s, expected, -1, 600);
+}
+
+int main()
+{
+    every_shape<std::less<int>>();
+    every_shape<std::greater<int>>();
+
+    random_ops<eytzinger_set<std::less<int>>>();
+    random_ops<flat_set<int>>();
+
+    // heavier keys take the same index code, with copies the sanitizers can follow
+    flat_set<std::string, std::less<std::string>, vector<std::string>, eytzinger_layout> words;
+    std::set<std::string> expected_words;
+    for (int i = 0; i < 300; i += 3)
+    {
+        words.insert(std::string(24, 'w') + std::to_string(1000 + i));
+        expected_words.insert(std::string(24, 'w') + std::to_string(1000 + i));
+    }
+    for (int i = -1; i < 301; ++i)
+    {
+        const std::string key = std::string(24, 'w') + std::to_string(1000 + i);
+        assert(words.contains(key) == expected_words.contains(key));
+        assert(words.lower_bound(key) - words.begin() == std::distance(expected_words.begin(), expected_words.lower_bound(key)));
+    }
+}
@@ -0,0 +1,31 @@
+#include "../containers/flat_set.hpp"
+
+#include <cassert>
+#include <ranges>
+#include <sstream>
+#include <iterator>
+
+template< class Set >
+void run()
+{
+    Set s{ 3, 10 };
+
+    // iterator and sentinel types differ
+    s.insert_range(std::views::iota(0) | std::views::take(5));
+    assert(s.size() == 6);
+
+    // single pass
+    std::istringstream in("7 1 9 7");
+    s.insert_range(std::ranges::subrange(std::istream_iterator<int>(in), std::istream_iterator<int>()));
+
+    const int expected[] = { 0, 1, 2, 3, 4, 7, 9, 10 };
+    assert(std::ranges::equal(s, expected));
+    for (int key : expected) assert(s.contains(key));
+    assert(!s.contains(5));
+}
+
+int main()
+{
+    run<flat_set<int>>();
+    run<flat_set<int, std::less<int>, vector<int>, eytzinger_layout>>();
+}
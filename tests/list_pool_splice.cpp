@@ -0,0 +1,48 @@
+#include "../containers/list.hpp"
+
+#include <cassert>
+#include <thread>
+
+int main()
+{
+    {
+        list<int> a{ 1, 2, 3 };
+        list<int> b{ 4, 5, 6 };
+        const node_pool_stats b_before = b.pool_stats();
+
+        a.splice(a.end(), b, b.begin());
+        a.splice(a.end(), b);
+        assert(a.size() == 6 && b.empty());
+
+        // each list still allocates from its own pool
+        a.push_back(7);
+        assert(b.pool_stats().allocations == b_before.allocations);
+        b.push_back(8);
+        assert(a.pool_stats().allocations == 4);
+
+        // a's nodes from b's slabs outlive b
+        { list<int> gone = std::move(b); }
+        int expected = 1;
+        for (int v : a) assert(v == expected++);
+        a.clear();
+        a.push_back(9);
+        assert(a.front() == 9);
+    }
+
+    {
+        // spliced lists can be used on different threads
+        list<int> a, b;
+        for (int i = 0; i < 100; ++i)
+        {
+            a.push_back(i);
+            b.push_back(i);
+        }
+        a.splice(a.begin(), b, b.begin());
+        b.splice(b.begin(), a, std::prev(a.end()));
+
+        std::thread t([&] { for (int i = 0; i < 10000; ++i) { a.push_back(i); a.pop_front(); } });
+        for (int i = 0; i < 10000; ++i) { b.push_back(i); b.pop_front(); }
+        t.join();
+        assert(a.size() == 100 && b.size() == 100);
+    }
+}
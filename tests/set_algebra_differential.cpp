@@ -0,0 +1,85 @@
+#include "../containers/set.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+#include <random>
+#include <vector>
+
+// merge, intersect and subtract against the std:: algorithms on sorted vectors, with inputs
+// large enough to be split over threads as well as small and lopsided ones
+
+static std::mt19937 rng(14);
+
+static std::vector<int> random_keys(std::size_t count, int range)
+{
+    std::vector<int> keys;
+    for (std::size_t i = 0; i < count; ++i) keys.push_back(std::uniform_int_distribution<int>(0, range)(rng));
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    return keys;
+}
+
+static void check(const set<int>& s, const std::vector<int>& expected)
+{
+    assert(s.size() == expected.size());
+    assert(std::equal(s.begin(), s.end(), expected.begin(), expected.end()));
+}
+
+static void run(std::size_t a_count, std::size_t b_count, int range, unsigned threads)
+{
+    const std::vector<int> a = random_keys(a_count, range);
+    const std::vector<int> b = random_keys(b_count, range);
+
+    std::vector<int> expected;
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+    {
+        set<int> lhs(a.begin(), a.end()), rhs(b.begin(), b.end());
+        lhs.merge(std::move(rhs), threads);
+        check(lhs, expected);
+        assert(rhs.empty());
+    }
+
+    expected.clear();
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+    {
+        set<int> lhs(a.begin(), a.end()), rhs(b.begin(), b.end());
+        lhs.intersect(std::move(rhs), threads);
+        check(lhs, expected);
+        assert(rhs.empty());
+    }
+
+    expected.clear();
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+    {
+        set<int> lhs(a.begin(), a.end()), rhs(b.begin(), b.end());
+        lhs.subtract(std::move(rhs), threads);
+        check(lhs, expected);
+        assert(rhs.empty());
+
+        // both sets stay usable: the result is an ordinary tree and source can grow again
+        rhs.insert(-1);
+        lhs.insert(range + 1);
+        lhs.erase(lhs.begin());
+        expected.push_back(range + 1);
+        expected.erase(expected.begin());
+        check(lhs, expected);
+        check(rhs, { -1 });
+    }
+}
+
+int main()
+{
+    for (unsigned threads : { 1u, 2u, 3u, 8u })
+    {
+        run(0, 0, 10, threads);
+        run(0, 100, 1000, threads);
+        run(100, 0, 1000, threads);
+        run(50, 50, 60, threads);
+        run(1, 100000, 200000, threads);
+        run(100000, 1, 200000, threads);
+        run(60000, 60000, 100000, threads);
+        run(100000, 3000, 1000000, threads);
+        run(40000, 40000, 10000000, threads);
+    }
+}
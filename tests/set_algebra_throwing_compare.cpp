@@ -0,0 +1,79 @@
+#include "../containers/set.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <stdexcept>
+#include <vector>
+
+// Fails on one chosen call, then compares normally again
+struct flaky_less
+{
+    static inline std::atomic<long> calls = 0;
+    static inline long fail_at = -1;
+
+    bool operator()(int lhs, int rhs) const
+    {
+        if (++calls == fail_at) throw std::runtime_error("comparison failed");
+        return lhs < rhs;
+    }
+};
+
+using flaky_set = set<int, flaky_less>;
+
+static void arm(long n)
+{
+    flaky_less::calls = 0;
+    flaky_less::fail_at = n;
+}
+
+// Valid, ordered and exactly the expected keys
+static void check(const flaky_set& s, const std::vector<int>& expected)
+{
+    assert(s.size() == expected.size());
+    std::size_t i = 0;
+    for (int key : s) assert(i < expected.size() && key == expected[i++]);
+    assert(i == expected.size());
+}
+
+static void run(int a_count, int b_count, unsigned threads)
+{
+    // b overlaps the upper half of a's keys
+    const int b_first = a_count - b_count / 2;
+    std::vector<int> all;
+    for (int i = 0; i < b_first + b_count; ++i) all.push_back(i);
+
+    using op_type = void (flaky_set::*)(flaky_set&&, unsigned);
+    const op_type ops[] = { &flaky_set::merge, &flaky_set::intersect, &flaky_set::subtract };
+
+    for (op_type op : ops)
+    {
+        for (long n = 1; ; n = n < 64 ? n + 1 : n * 3 / 2)
+        {
+            arm(-1);
+            flaky_set a, b;
+            for (int i = 0; i < a_count; ++i) a.insert(i);
+            for (int i = 0; i < b_count; ++i) b.insert(b_first + i);
+
+            arm(n);
+            try
+            {
+                (a.*op)(std::move(b), threads);
+                arm(-1);
+                break;
+            }
+            catch (const std::runtime_error&)
+            {
+                arm(-1);
+                assert(b.empty());
+                check(a, all);
+            }
+        }
+    }
+}
+
+int main()
+{
+    run(100, 100, 1);
+    run(1000, 37, 1);
+    run(1 << 15, 1 << 14, 4);
+}
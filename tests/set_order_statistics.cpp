@@ -0,0 +1,23 @@
+#include "../containers/set.hpp"
+
+#include <cassert>
+#include <iterator>
+#include <ranges>
+
+int main()
+{
+    order_statistic_set<int> s{ 1, 2, 3 };
+    assert(std::next(s.begin(), 2) - s.begin() == 2);
+    assert(s.begin() - s.end() == -3);
+    assert(std::ranges::distance(s) == 3);
+    assert(std::ranges::distance(s.begin(), s.end()) == 3);
+
+    order_statistic_set<int> big;
+    for (int i = 0; i < 1000; ++i) big.insert((i * 7919) % 1000);
+    auto it = big.begin();
+    for (int i = 0; i < 1000; ++i, ++it)
+    {
+        assert(it - big.begin() == i);
+        assert(big.end() - it == 1000 - i);
+    }
+}
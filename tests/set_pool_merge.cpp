@@ -0,0 +1,45 @@
+#include "../containers/set.hpp"
+
+#include <cassert>
+#include <thread>
+
+int main()
+{
+    {
+        set<int> a, b;
+        for (int i = 0; i < 100; ++i)
+        {
+            a.insert(i);
+            b.insert(i + 50);
+        }
+        const node_pool_stats a_before = a.pool_stats();
+
+        a.merge(std::move(b));
+        assert(a.size() == 150 && b.empty());
+
+        // the emptied source allocates from its own pool, not from a's
+        b.insert(1);
+        assert(a.pool_stats().allocations == a_before.allocations);
+
+        // a's nodes from b's slabs outlive b
+        { set<int> gone = std::move(b); }
+        int expected = 0;
+        for (int v : a) assert(v == expected++);
+    }
+
+    {
+        // merged sets can be used on different threads
+        set<int> a, b;
+        for (int i = 0; i < 100; ++i)
+        {
+            a.insert(i);
+            b.insert(i + 50);
+        }
+        a.merge(std::move(b));
+
+        std::thread t([&] { for (int i = 0; i < 10000; ++i) a.erase(a.insert(1000 + i).first); });
+        for (int i = 0; i < 10000; ++i) b.erase(b.insert(i).first);
+        t.join();
+        assert(a.size() == 150 && b.empty());
+    }
+}
@@ -0,0 +1,183 @@
+#include "../containers/string.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Appending and concatenation against std::string, with operands that are part of the string
+// being written to, on both sides of a reallocation. Counting allocations checks that a chain
+// of + allocates once and that appends grow geometrically.
+
+template< class T >
+struct counting_allocator
+{
+    using value_type = T;
+
+    static inline std::size_t allocations = 0;
+
+    counting_allocator() = default;
+    template< class U >
+    counting_allocator(const counting_allocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n)
+    {
+        ++allocations;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) noexcept { std::allocator<T>().deallocate(p, n); }
+
+    friend bool operator==(const counting_allocator&, const counting_allocator&) noexcept { return true; }
+};
+
+using counted_string = basic_string<char, std::char_traits<char>, counting_allocator<char>>;
+
+static std::mt19937 rng(23);
+
+static std::size_t below(std::size_t n) { return std::uniform_int_distribution<std::size_t>(0, n - 1)(rng); }
+
+static std::string random_text(std::size_t n)
+{
+    std::string text;
+    for (std::size_t i = 0; i < n; ++i) text += static_cast<char>('a' + below(26));
+    return text;
+}
+
+static void check(const string& s, const std::string& expected)
+{
+    assert(s.size() == expected.size());
+    assert(std::string_view(s.data(), s.size()) == expected);
+    assert(s.c_str()[s.size()] == '\0');
+}
+
+// spare capacity or none, so the same operation runs in place and through a new buffer
+static string make(const std::string& text, bool spare)
+{
+    string s(text.data(), text.size());
+    if (spare) s.reserve(4 * text.size() + 64);
+    return s;
+}
+
+static void aliasing(std::size_t n, bool spare)
+{
+    const std::string t = random_text(n);
+    const std::size_t from = below(n + 1);
+    const std::size_t count = below(n - from + 1);
+
+    {
+        string s = make(t, spare);
+        s += s;
+        check(s, t + t);
+    }
+    {
+        string s = make(t, spare);
+        s.append(s.data() + from, count);
+        check(s, t + t.substr(from, count));
+    }
+    {
+        string s = make(t, spare);
+        s.append(s, from, count);
+        check(s, t + t.substr(from, count));
+    }
+    {
+        string s = make(t, spare);
+        s.append(s.begin() + from, s.begin() + from + count);
+        check(s, t + t.substr(from, count));
+    }
+    {
+        string s = make(t, spare);
+        s.append(s.substr(from, count));
+        check(s, t + t.substr(from, count));
+    }
+    {
+        // every piece of the expression reads the string it is appended to
+        string s = make(t, spare);
+        s += s + '-' + s.substr(from, count) + s.c_str();
+        check(s, t + t + '-' + t.substr(from, count) + t);
+    }
+    {
+        string s = make(t, spare);
+        s = s + s;
+        check(s, t + t);
+    }
+    {
+        // an rvalue on the left is appended to, here with itself on the right
+        string s = make(t, spare);
+        s = std::move(s) + s;
+        check(s, t + t);
+    }
+    {
+        string s = make(t, spare);
+        s = std::move(s) + s.c_str();
+        check(s, t + t);
+    }
+}
+
+static void chains()
+{
+    for (int round = 0; round < 2000; ++round)
+    {
+        const std::string a = random_text(below(40)), b = random_text(below(40)), c = random_text(below(40));
+        const string sa(a.data(), a.size()), sb(b.data(), b.size()), sc(c.data(), c.size());
+        const std::string_view view(c);
+        const basic_string_view<char> own_view(c.data(), c.size());
+
+        const string left_to_right = sa + sb + 'x' + sc + "lit" + own_view;
+        check(left_to_right, a + b + 'x' + c + "lit" + std::string(view));
+
+        const string nested = (sa + 'y') + ("lit" + sb) + (sc + sa);
+        check(nested, a + 'y' + "lit" + b + c + a);
+
+        const string mixed = 'z' + sa + sb.c_str() + (own_view + sc);
+        check(mixed, 'z' + a + b + c + c);
+
+        string appended(b.data(), b.size());
+        appended += sa + sc + 'w';
+        check(appended, b + a + c + 'w');
+    }
+}
+
+static void allocations()
+{
+    const counted_string piece(40, 'p');
+
+    // one buffer for any number of pieces
+    std::size_t before = counting_allocator<char>::allocations;
+    const counted_string joined = piece + piece + 'c' + "literal" + piece + piece;
+    assert(counting_allocator<char>::allocations == before + 1);
+    assert(joined.size() == 4 * 40 + 1 + 7);
+
+    counted_string target(counted_string(300, 't'));
+    target.reserve(1000);
+    before = counting_allocator<char>::allocations;
+    target += piece + piece + piece;
+    assert(counting_allocator<char>::allocations == before);
+
+    // a million single characters in about log2(1e6) buffers
+    counted_string grown;
+    before = counting_allocator<char>::allocations;
+    for (int i = 0; i < 1000000; ++i) grown.push_back('g');
+    assert(counting_allocator<char>::allocations - before <= 20);
+
+    counted_string appended;
+    before = counting_allocator<char>::allocations;
+    for (int i = 0; i < 100000; ++i) appended.append("abc", 3);
+    assert(counting_allocator<char>::allocations - before <= 20);
+    assert(appended.size() == 300000);
+}
+
+int main()
+{
+    for (std::size_t n = 0; n <= 80; ++n)
+        for (int repeat = 0; repeat < 20; ++repeat)
+        {
+            aliasing(n, false);
+            aliasing(n, true);
+        }
+
+    chains();
+    allocations();
+}
@@ -0,0 +1,80 @@
+#include "../containers/string.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <random>
+#include <string>
+
+// Every search against std::string on random text. Built once as is, which takes the AVX2
+// kernels on a CPU that has them, and once with STRING_SEARCH_NO_AVX2 for the SSE2 ones.
+
+static std::mt19937 rng(22);
+
+static std::size_t below(std::size_t n) { return std::uniform_int_distribution<std::size_t>(0, n - 1)(rng); }
+
+// Few distinct bytes so that needles and sets hit often, some of them above 0x7F
+static std::string random_text(std::size_t n, std::size_t alphabet)
+{
+    static const char bytes[] = "abcdefgh\x80\xC3\xFF\x01";
+    std::string text;
+    for (std::size_t i = 0; i < n; ++i) text += bytes[below(alphabet)];
+    return text;
+}
+
+static std::size_t random_pos(std::size_t n)
+{
+    switch (below(4))
+    {
+    case 0: return std::string::npos;
+    case 1: return n + below(3);
+    default: return below(n + 1);
+    }
+}
+
+static void check(const std::string& expected_text, const std::string& needle, std::size_t pos)
+{
+    const string text(expected_text.data(), expected_text.size());
+    const char* s = needle.data();
+    const std::size_t m = needle.size();
+
+    assert(text.find(s, pos, m) == expected_text.find(s, pos, m));
+    assert(text.rfind(s, pos, m) == expected_text.rfind(s, pos, m));
+    assert(text.find_first_of(s, pos, m) == expected_text.find_first_of(s, pos, m));
+    assert(text.find_last_of(s, pos, m) == expected_text.find_last_of(s, pos, m));
+    assert(text.find_first_not_of(s, pos, m) == expected_text.find_first_not_of(s, pos, m));
+    assert(text.find_last_not_of(s, pos, m) == expected_text.find_last_not_of(s, pos, m));
+}
+
+int main()
+{
+    for (int round = 0; round < 20000; ++round)
+    {
+        // past two AVX2 blocks, so blocks, tails and pos inside a block all come up
+        const std::size_t n = below(100);
+        const std::string text = random_text(n, 2 + below(11));
+
+        // a piece of the text half of the time, else random; sets beyond the SSE2 member limit too
+        std::string needle;
+        if (n != 0 && below(2) == 0)
+        {
+            const std::size_t at = below(n);
+            needle = text.substr(at, below(std::min<std::size_t>(n - at, 40) + 1));
+        }
+        else needle = random_text(below(24), 2 + below(11));
+
+        check(text, needle, random_pos(n));
+        check(text, needle, 0);
+        check(text, needle, std::string::npos);
+    }
+
+    // a match that straddles the end of a vector block, from either side
+    for (std::size_t n = 1; n <= 80; ++n)
+        for (std::size_t m = 1; m <= 5 && m <= n; ++m)
+            for (std::size_t at = 0; at + m <= n; ++at)
+            {
+                std::string text(n, 'a');
+                for (std::size_t i = 0; i < m; ++i) text[at + i] = static_cast<char>('b' + i);
+                check(text, text.substr(at, m), 0);
+                check(text, "a", std::string::npos);
+            }
+}
@@ -0,0 +1,128 @@
+#include "../containers/string.hpp"
+
+#include <cassert>
+#include <string>
+
+// Strings at and around the longest length kept in the object, against std::basic_string,
+// for each character width: the short form stores its size in the last slot, which becomes
+// the terminator of a full short string, so the lengths next to short_capacity are the risky ones
+
+template< class CharT >
+static std::basic_string<CharT> text(std::size_t n, std::size_t seed = 0)
+{
+    std::basic_string<CharT> s;
+    for (std::size_t i = 0; i < n; ++i) s += static_cast<CharT>('a' + (i + seed) % 26);
+    return s;
+}
+
+template< class String >
+static bool inside(const String& s)
+{
+    const auto* at = reinterpret_cast<const unsigned char*>(s.data());
+    const auto* object = reinterpret_cast<const unsigned char*>(&s);
+    return at >= object && at < object + sizeof(String);
+}
+
+template< class String, class CharT >
+static void check(const String& s, const std::basic_string<CharT>& expected)
+{
+    assert(s.size() == expected.size());
+    assert(s.empty() == expected.empty());
+    assert(std::basic_string<CharT>(s.data(), s.size()) == expected);
+    assert(s.c_str()[s.size()] == CharT());
+    assert(s.capacity() >= s.size());
+    assert(inside(s) == (s.capacity() == String::short_capacity));
+}
+
+template< class CharT >
+static void run()
+{
+    using String = basic_string<CharT>;
+    constexpr std::size_t cap = String::short_capacity;
+    static_assert(sizeof(String) == 3 * sizeof(void*));
+    static_assert((cap + 1) * sizeof(CharT) == sizeof(String));
+
+    for (std::size_t n = 0; n <= cap + 2; ++n)
+    {
+        const std::basic_string<CharT> expected = text<CharT>(n);
+
+        const String s(expected.data(), n);
+        check(s, expected);
+        assert(inside(s) == (n <= cap));
+
+        const String filled(n, CharT('x'));
+        check(filled, std::basic_string<CharT>(n, CharT('x')));
+
+        String copy = s;
+        check(copy, expected);
+
+        String moved = std::move(copy);
+        check(moved, expected);
+        check(copy, std::basic_string<CharT>());
+
+        // growing one character at a time crosses into the heap exactly past cap
+        String grown;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            grown.push_back(expected[i]);
+            assert(inside(grown) == (i + 1 <= cap));
+        }
+        check(grown, expected);
+
+        // and shrink_to_fit brings a short enough string back into the object
+        String shrunk = s;
+        shrunk.reserve(4 * cap);
+        check(shrunk, expected);
+        shrunk.shrink_to_fit();
+        check(shrunk, expected);
+        assert(inside(shrunk) == (n <= cap));
+
+        // assignment and swap between every pair of forms, the target's storage reused or not
+        for (std::size_t m = 0; m <= cap + 2; ++m)
+        {
+            const std::basic_string<CharT> other_text = text<CharT>(m, 7);
+            String target(other_text.data(), m);
+            target = s;
+            check(target, expected);
+
+            String a(other_text.data(), m);
+            String b = s;
+            a.swap(b);
+            check(a, expected);
+            check(b, other_text);
+
+            String appended(other_text.data(), m);
+            appended.append(s);
+            check(appended, other_text + expected);
+
+            String assigned(other_text.data(), m);
+            assigned = s.c_str();
+            check(assigned, expected);
+        }
+
+        // a string assigned or appended from itself
+        String self = s;
+        self = self;
+        check(self, expected);
+        self.append(self);
+        const std::basic_string<CharT> doubled = expected + expected;
+        check(self, doubled);
+        self.append(self.data() + n / 2, n);
+        check(self, doubled + doubled.substr(n / 2, n));
+
+        String cleared = s;
+        cleared.clear();
+        check(cleared, std::basic_string<CharT>());
+        cleared.append(expected.data(), n);
+        check(cleared, expected);
+    }
+}
+
+int main()
+{
+    run<char>();
+    run<wchar_t>();
+    run<char8_t>();
+    run<char16_t>();
+    run<char32_t>();
+}
@@ -0,0 +1,35 @@
+#include "../containers/vector.hpp"
+#include "../containers/allocators.hpp"
+
+#include <cassert>
+
+int main()
+{
+    pool_resource pr;
+
+    {
+        // starts without a buffer, so the first growth and the destructor see (nullptr, 0)
+        vector<int, pool_allocator<int>> v{ pool_allocator<int>(pr) };
+        v.push_back(1);
+        assert(v.size() == 1 && v[0] == 1);
+
+        for (int i = 2; i <= 1000; ++i) v.push_back(i);
+        v.insert(v.begin(), 0);
+        assert(v.size() == 1001 && v.front() == 0 && v.back() == 1000);
+
+        v.clear();
+        v.shrink_to_fit();
+    }
+
+    {
+        vector<int, pool_allocator<int>> empty{ pool_allocator<int>(pr) };
+        vector<int, pool_allocator<int>> other{ pool_allocator<int>(pr) };
+        other = std::move(empty);
+        other.insert(other.end(), 3, 7);
+        assert(other.size() == 3 && other[2] == 7);
+    }
+
+    pr.deallocate(nullptr, 0);
+    pr.deallocate(nullptr, 64);
+    assert(pr.allocate(0) == nullptr);
+}
@@ -0,0 +1,58 @@
+#include "../containers/vector.hpp"
+#include "../containers/allocators.hpp"
+
+#include <cassert>
+
+// Allocator that propagates on swap, tagged so the test can see it move
+template< class T >
+struct tagged_allocator : std::allocator<T>
+{
+    using value_type = T;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    int tag = 0;
+
+    tagged_allocator(int tag = 0) noexcept : tag(tag) {}
+    template< class U >
+    tagged_allocator(const tagged_allocator<U>& other) noexcept : tag(other.tag) {}
+
+    friend bool operator==(const tagged_allocator& lhs, const tagged_allocator& rhs) noexcept { return lhs.tag == rhs.tag; }
+};
+
+int main()
+{
+    {
+        vector<int> a{ 1, 2, 3 };
+        vector<int> b{ 4 };
+        const int* a_data = a.data();
+
+        a.swap(b);
+        assert(a.size() == 1 && a[0] == 4);
+        assert(b.size() == 3 && b[2] == 3 && b.data() == a_data);
+
+        using std::swap;
+        swap(a, b);
+        assert(a.size() == 3 && b.size() == 1);
+    }
+
+    {
+        vector<int, tagged_allocator<int>> a({ 1, 2 }, tagged_allocator<int>(1));
+        vector<int, tagged_allocator<int>> b({ 3 }, tagged_allocator<int>(2));
+
+        a.swap(b);
+        assert(a.get_allocator().tag == 2 && a.size() == 1 && a[0] == 3);
+        assert(b.get_allocator().tag == 1 && b.size() == 2 && b[1] == 2);
+    }
+
+    {
+        // does not propagate, so both must share one resource
+        pool_resource pool;
+        vector<int, pool_allocator<int>> a({ 1, 2, 3 }, pool_allocator<int>(pool));
+        vector<int, pool_allocator<int>> b{ pool_allocator<int>(pool) };
+
+        a.swap(b);
+        assert(a.empty() && b.size() == 3);
+        static_assert(!noexcept(a.swap(b)));
+    }
+}
@@ -0,0 +1,97 @@
+#include "../containers/vector.hpp"
+#include "../containers/small_vector.hpp"
+
+#include <cassert>
+#include <new>
+#include <string>
+
+// Copy-only element whose copy constructor fails on a chosen call, like a copy that
+// runs out of memory. The string is long enough to live on the heap, so an element
+// destroyed twice or never built shows up under a sanitizer.
+struct copy_only
+{
+    static inline int copies = 0;
+    static inline int fail_at = -1;
+    static inline int live = 0;
+
+    std::string text;
+
+    explicit copy_only(int i) : text(49, static_cast<char>('a' + i % 26)) { ++live; }
+    copy_only(const copy_only& other) : text(other.text)
+    {
+        if (++copies == fail_at) throw std::bad_alloc();
+        ++live;
+    }
+    copy_only& operator=(const copy_only& other)
+    {
+        if (++copies == fail_at) throw std::bad_alloc();
+        text = other.text;
+        return *this;
+    }
+    ~copy_only() { --live; }
+};
+
+static void arm(int n)
+{
+    copy_only::copies = 0;
+    copy_only::fail_at = n;
+}
+
+// Every slot below size() holds a live element, and nothing else is alive but x
+template< class Vector >
+static void check_intact(const Vector& v)
+{
+    assert(copy_only::live == static_cast<int>(v.size()) + 1);
+    for (const copy_only& e : v) assert(e.text.size() == 49);
+}
+
+template< class Vector >
+static void run(Vector& v)
+{
+    v.reserve(16);
+    for (int i = 0; i < 8; ++i) v.push_back(copy_only(i));
+    const copy_only x(100);
+
+    for (int n = 1; n < 12; ++n)
+    {
+        const std::size_t before = v.size();
+        arm(n);
+        try
+        {
+            v.insert(v.begin(), x);
+            assert(v.size() == before + 1);
+            v.erase(v.begin());
+        }
+        catch (const std::bad_alloc&) {}
+        check_intact(v);
+    }
+
+    for (int n = 1; n < 20; ++n)
+    {
+        arm(n);
+        try { v.insert(v.begin() + 2, 3, x); }
+        catch (const std::bad_alloc&) {}
+        check_intact(v);
+
+        arm(n);
+        try { v.erase(v.begin() + 1, v.begin() + 3); }
+        catch (const std::bad_alloc&) {}
+        check_intact(v);
+    }
+    arm(-1);
+}
+
+int main()
+{
+    {
+        vector<copy_only> v;
+        run(v);
+    }
+    assert(copy_only::live == 0);
+
+    {
+        small_vector<copy_only, 16> v;
+        run(v);
+    }
+    assert(copy_only::live == 0);
+}